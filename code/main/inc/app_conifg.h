@@ -10,20 +10,45 @@
 // ===== Queue =====
 #define SENSOR_QUEUE_LENGTH         256
 
+// ===== Flight events (event_log.c) =====
+#define EVENT_QUEUE_LENGTH          16
+#define EVENT_FLUSH_MAX_LATENCY_MS  50     // post -> fsync'd on the card
+#define EVENT_POLL_MS               10     // logger wake-up bound when no samples arrive
+#define LAUNCH_ACCEL_THRESHOLD_MG   1800   // |a| above this (must sit below the accel full scale) ...
+#define LAUNCH_DETECT_MS            100    // ... for this long latches launch
+#define OVERFLOW_BURST_QUIET_MS     1000   // no sensor_queue overwrite for this long ends a burst
+
 // ===== SD logging =====
 #define SD_MOUNT_POINT              "/sdcard"
 #define SD_LOG_FILENAME             "/sdcard/flight.csv"
+#define SD_SUMMARY_FILENAME         "/sdcard/summary.bin"
+#define SUMMARY_WINDOW_MS           1000   // per-window stats record (summary_stats.c)
 #define SD_FLUSH_INTERVAL_MS        100
 #define SD_BUFFER_SIZE_BYTES        4096
+#define SD_RETRY_INTERVAL_MS        2000   // first mount is attempted immediately
+
+// ===== Boot budget (ms since app start, bootloader time excluded) =====
+#define BOOT_FIRST_SAMPLE_BUDGET_MS     50
+#define BOOT_FIRST_SD_WRITE_BUDGET_MS   500
 
 // ===== Tasks =====
 #define SENSOR_TASK_STACK_WORDS     4096
 #define LOGGER_TASK_STACK_WORDS     6144
-#define STATUS_TASK_STACK_WORDS     2048
+#define STATUS_TASK_STACK_WORDS     3072   // console printf needs headroom
+#define I2C_RECOVERY_TASK_STACK_WORDS 3072
 
 #define SENSOR_TASK_PRIORITY        10
 #define LOGGER_TASK_PRIORITY        8
 #define STATUS_TASK_PRIORITY        3
+#define I2C_RECOVERY_TASK_PRIORITY  5
+
+// ===== Memory =====
+// 1: every task, queue and buffer is carved out of one static arena (app_mem.c)
+// 0: legacy heap allocation (xTaskCreate / xQueueCreate / malloc)
+#ifndef APP_STATIC_ALLOCATION
+#define APP_STATIC_ALLOCATION       1
+#endif
+#define APP_MEM_REPORT_INTERVAL_MS  10000
 
 // ===== I2C (shared bus: MPU + BMP280) =====
 #define I2C_PORT_NUM                0
@@ -35,6 +60,27 @@
 #define MPU_I2C_ADDR                0x68
 #define BMP280_I2C_ADDR             0x76   // change to 0x77 if required
 
+// I2C deadlines and recovery
+#define I2C_XFER_TIMEOUT_MS         50     // cap on any single transfer
+#define I2C_INIT_TIMEOUT_MS         200    // whole init sequence, per sensor
+#define I2C_READ_BUDGET_MS          3      // lock + read, per sensor, per cycle
+#define SENSOR_FAIL_THRESHOLD       5      // consecutive misses before recovery
+#define I2C_RECOVERY_RETRY_MS       500
+#ifndef I2C_BUS_FAULT_INJECTION
+#define I2C_BUS_FAULT_INJECTION     0      // 1: enable i2c_bus_inject_fault() for bench tests
+#endif
+
+// ===== Debug console =====
+#define CONSOLE_UART_NUM            0
+#define STATUS_RATE_INTERVAL_MS     1000   // queue depth / SD throughput gauges
+
+// ===== Log download over console UART =====
+#define LOG_DL_BAUD                 921600
+#define LOG_DL_WINDOW_CHUNKS        8      // unacked 1 KiB chunks in flight
+#define LOG_DL_POLL_MS              10
+#define LOG_DL_ACK_TIMEOUT_MS       250    // rewind to oldest unacked chunk
+#define LOG_DL_IDLE_TIMEOUT_MS      30000  // give the console back
+
 // ===== SD over SPI (SDSPI) =====
 #define SD_SPI_HOST                 SPI2_HOST   // VSPI on many ESP32 examples
 #define SD_MOSI_GPIO                23
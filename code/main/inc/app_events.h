@@ -4,3 +4,4 @@
 #define EVT_BARO_OK         (1U << 1)
 #define EVT_SD_OK           (1U << 2)
 #define EVT_LOGGING_ACTIVE  (1U << 3)
+#define EVT_I2C_RECOVERY    (1U << 4)
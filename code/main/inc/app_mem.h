@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+/*
+ * All long-lived RTOS objects and large buffers go through here so that the
+ * APP_STATIC_ALLOCATION switch is the only place that decides arena vs heap.
+ */
+void *app_mem_alloc(size_t size);
+
+TaskHandle_t app_mem_create_task(TaskFunction_t fn, const char *name, uint32_t stack_depth, UBaseType_t prio);
+QueueHandle_t app_mem_create_queue(UBaseType_t length, UBaseType_t item_size);
+SemaphoreHandle_t app_mem_create_mutex(void);
+EventGroupHandle_t app_mem_create_event_group(void);
+
+size_t app_mem_arena_used(void);
+size_t app_mem_arena_capacity(void);
+
+/* Logs arena usage, per-task stack high-water marks and heap headroom. */
+void app_mem_report(void);
@@ -14,8 +14,29 @@ typedef struct
     uint8_t baro_ok;
 } sensor_sample_t;
 
+/*
+ * Rare, important records (sensor drop-outs, SD remounts, launch) that go
+ * through event_queue rather than the sample path; see event_log.h.
+ */
+typedef enum
+{
+    FLIGHT_EVT_SENSOR_UP = 1,   // arg: flight_sensor_t
+    FLIGHT_EVT_SENSOR_DOWN,     // arg: flight_sensor_t
+    FLIGHT_EVT_SD_MOUNTED,      // arg: mount count
+    FLIGHT_EVT_SD_LOST,         // arg: 0
+    FLIGHT_EVT_OVERFLOW_BURST,  // arg: total queue overwrites so far
+    FLIGHT_EVT_LAUNCH,          // arg: peak accel magnitude, milli-g
+} flight_event_type_t;
+
+typedef enum
+{
+    FLIGHT_SENSOR_IMU = 0,
+    FLIGHT_SENSOR_BARO,
+} flight_sensor_t;
+
 typedef struct
 {
-    uint32_t overwrite_count;
-    uint32_t last_overwrite_time_ms;
-} queue_stats_t;
+    uint32_t t_ms;
+    uint8_t type;       // flight_event_type_t
+    int32_t arg;
+} flight_event_t;
@@ -5,4 +5,8 @@
 #include "app_types.h"
 
 bool baro_init(SemaphoreHandle_t i2c_mutex);
-bool baro_read_pressure(sensor_sample_t *sample, SemaphoreHandle_t i2c_mutex);
+
+/* baro_init() in two halves; other bus work can run in between. */
+bool baro_reset(SemaphoreHandle_t i2c_mutex);
+bool baro_configure(SemaphoreHandle_t i2c_mutex);
+bool baro_read_pressure(sensor_sample_t *sample, SemaphoreHandle_t i2c_mutex, TickType_t deadline);
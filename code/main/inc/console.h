@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+ * Minimal line-based debug console on the console UART. Served from
+ * status_task, so it runs at the lowest application priority and never
+ * touches the sensor/logger paths beyond reading their metrics.
+ */
+void console_init(void);
+void console_poll(void);
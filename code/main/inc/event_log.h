@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "app_types.h"
+
+/*
+ * Priority lane for flight events. Posting never blocks, so it is safe from
+ * the sampling path; a full queue drops the new event and counts it in
+ * events.dropped. logger_task writes events ahead of queued samples and
+ * syncs them to the card within EVENT_FLUSH_MAX_LATENCY_MS.
+ */
+/* Registers the event metrics; called from app_init() before any task starts. */
+void event_log_init(void);
+
+bool event_log_post(flight_event_type_t type, int32_t arg);
+
+/* Formats one event as a "# evt ..." comment line for flight.csv. */
+int event_log_format(const flight_event_t *e, char *buf, size_t len);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "app_config.h"
+
+void i2c_bus_init(void);
+
+/*
+ * Bus operations take an absolute tick deadline rather than a timeout, so a
+ * caller can give a whole cycle (lock + transfers) one budget.
+ */
+TickType_t i2c_bus_deadline_in(uint32_t ms);
+
+bool i2c_bus_lock(SemaphoreHandle_t i2c_mutex, TickType_t deadline);
+void i2c_bus_unlock(SemaphoreHandle_t i2c_mutex);
+
+bool i2c_bus_read_reg(uint8_t addr7, uint8_t reg, uint8_t *buf, size_t len, TickType_t deadline);
+
+/* Raw write of `len` bytes in one transaction (register address included by the caller). */
+bool i2c_bus_write(uint8_t addr7, const uint8_t *data, size_t len, TickType_t deadline);
+
+/*
+ * Frees a wedged bus: removes the driver, clocks SCL until slaves release SDA,
+ * issues a STOP and reinstalls the driver. Takes i2c_mutex itself.
+ */
+bool i2c_bus_recover(SemaphoreHandle_t i2c_mutex);
+
+#if I2C_BUS_FAULT_INJECTION
+typedef enum
+{
+    I2C_FAULT_NONE = 0,
+    I2C_FAULT_NACK,     // transfer fails immediately
+    I2C_FAULT_HANG,     // transfer blocks until its deadline, then fails
+} i2c_fault_t;
+
+/* Applies `fault` to the next `count` transfers addressed to addr7. */
+void i2c_bus_inject_fault(uint8_t addr7, i2c_fault_t fault, uint32_t count);
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+/*
+ * Serves files from the SD card over the console UART using the protocol in
+ * log_download_proto.h. Blocks the caller until the host sends QUIT or the
+ * link has been idle for LOG_DL_IDLE_TIMEOUT_MS, then restores the console.
+ */
+void log_download_serve(void);
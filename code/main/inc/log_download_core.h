@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+ * Device end of the log download protocol (log_download_proto.h) with the
+ * UART, file and clock left to the caller. log_download.c drives it on the
+ * board; tools/log_download/logdl_loopback_test.c drives the same code over a
+ * pty, so this header and its source must stay free of ESP-IDF includes.
+ *
+ * Sending is go-back-N: up to window_bytes past the oldest unacked byte
+ * (base) are in flight, next is the next byte to send. ACK moves base, NAK
+ * moves both back to the first missing byte, and ack_timeout_ms without
+ * progress rewinds next to base.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "log_download_proto.h"
+
+typedef struct
+{
+    void *ctx;
+    /* Opens a validated name and reports its size; 0 or an error code. */
+    logdl_err_t (*open)(void *ctx, const uint8_t *name, uint16_t len, uint32_t *size);
+    void (*close)(void *ctx);
+    /* Reads exactly len bytes at offset into a buffer the callee owns. */
+    const uint8_t *(*read)(void *ctx, uint32_t offset, uint16_t len);
+    void (*send)(void *ctx, uint8_t type, uint8_t flags, uint32_t offset, const void *payload, uint16_t len);
+} logdl_io_t;
+
+typedef struct
+{
+    const logdl_io_t *io;
+    uint32_t window_bytes;
+    uint32_t ack_timeout_ms;
+    uint32_t idle_timeout_ms;
+
+    bool active;
+    bool done_sent;
+    uint32_t size;
+    uint32_t base;          // oldest unacked byte
+    uint32_t next;          // next byte to send
+
+    uint32_t last_rx_ms;
+    uint32_t last_progress_ms;
+    uint32_t rewinds;       // ACK timeouts that resent data
+} logdl_session_t;
+
+void logdl_session_init(logdl_session_t *s, const logdl_io_t *io, uint32_t window_bytes,
+                        uint32_t ack_timeout_ms, uint32_t idle_timeout_ms, uint32_t now_ms);
+
+/* Fills the send window, then sends DONE once everything is acked. */
+void logdl_session_pump(logdl_session_t *s, uint32_t now_ms);
+
+/* One valid frame from the host. Returns false on QUIT. */
+bool logdl_session_handle(logdl_session_t *s, const logdl_hdr_t *h, const uint8_t *payload, uint32_t now_ms);
+
+/* Timers, once per poll. Returns false when the link has gone idle. */
+bool logdl_session_tick(logdl_session_t *s, uint32_t now_ms);
+
+/* Shuts the file and ends the session. */
+void logdl_session_close(logdl_session_t *s);
@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ * Wire format for pulling log files over the console UART. Shared verbatim
+ * with the host client (tools/log_download), so this header must stay free
+ * of ESP-IDF includes. All fields are little-endian; both ends are LE.
+ *
+ * Flow:
+ *   host   OPEN(offset=resume point, payload=file name)
+ *   device INFO(offset=file size) or ERROR(flags=code)
+ *   device DATA(offset, payload) ... up to a window of unacked chunks
+ *   host   ACK(offset=next byte expected)       cumulative
+ *   host   NAK(offset=first missing byte)       go-back-N from there
+ *   device DONE(offset=file size) once everything is acked
+ *   host   QUIT
+ *
+ * Resume after a disconnect is just a fresh OPEN at the bytes already saved.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOGDL_SYNC0             0x46    // 'F'
+#define LOGDL_SYNC1             0x4C    // 'L'
+#define LOGDL_MAX_PAYLOAD       1024
+#define LOGDL_MAX_NAME          32
+
+typedef enum
+{
+    LOGDL_OPEN  = 1,
+    LOGDL_INFO  = 2,
+    LOGDL_DATA  = 3,
+    LOGDL_ACK   = 4,
+    LOGDL_NAK   = 5,
+    LOGDL_DONE  = 6,
+    LOGDL_ERROR = 7,
+    LOGDL_QUIT  = 8,
+} logdl_type_t;
+
+typedef enum
+{
+    LOGDL_ERR_NO_CARD   = 1,
+    LOGDL_ERR_NOT_FOUND = 2,
+    LOGDL_ERR_IO        = 3,
+    LOGDL_ERR_BAD_NAME  = 4,
+} logdl_err_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t  sync[2];
+    uint8_t  type;
+    uint8_t  flags;
+    uint32_t offset;
+    uint16_t len;
+    uint16_t reserved;
+    uint32_t crc;       // CRC-32 of header (crc = 0) followed by payload
+} logdl_hdr_t;
+
+_Static_assert(sizeof(logdl_hdr_t) == 16, "logdl_hdr_t must be 16 bytes");
+
+/* zlib-compatible CRC-32 (start with 0), nibble table: small and fast enough at UART rates. */
+static inline uint32_t logdl_crc32(uint32_t crc, const void *data, size_t len)
+{
+    static const uint32_t t[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ t[crc & 0x0F];
+        crc = (crc >> 4) ^ t[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static inline uint32_t logdl_frame_crc(const logdl_hdr_t *h, const void *payload)
+{
+    logdl_hdr_t tmp = *h;
+    tmp.crc = 0;
+
+    uint32_t crc = logdl_crc32(0, &tmp, sizeof(tmp));
+    return logdl_crc32(crc, payload, h->len);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Lightweight named metrics. Registration is get-or-create by name and is
+ * meant for task start-up; updates are single relaxed atomics so they are
+ * safe from the sampling path (no locks, no allocation).
+ */
+
+#define METRICS_MAX             32
+#define METRIC_HIST_BUCKETS     24      // bucket i holds values < 2^i; last (>= 2^22, ~4 s in us) is overflow
+
+typedef enum
+{
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+} metric_type_t;
+
+typedef struct
+{
+    const char *name;
+    metric_type_t type;
+
+    uint32_t value;                         // counter / gauge; histogram max
+    uint32_t buckets[METRIC_HIST_BUCKETS];  // histogram only
+} metric_t;
+
+/* Never return NULL: a full registry hands back a shared scratch metric. */
+metric_t *metrics_counter(const char *name);
+metric_t *metrics_gauge(const char *name);
+metric_t *metrics_histogram(const char *name);
+
+static inline void metrics_add(metric_t *m, uint32_t n)
+{
+    __atomic_fetch_add(&m->value, n, __ATOMIC_RELAXED);
+}
+
+static inline void metrics_inc(metric_t *m)
+{
+    metrics_add(m, 1);
+}
+
+static inline void metrics_set(metric_t *m, uint32_t v)
+{
+    __atomic_store_n(&m->value, v, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t metrics_get(const metric_t *m)
+{
+    return __atomic_load_n(&m->value, __ATOMIC_RELAXED);
+}
+
+static inline void metrics_observe(metric_t *m, uint32_t v)
+{
+    uint32_t b = v ? (uint32_t)(32 - __builtin_clz(v)) : 0;
+    if (b >= METRIC_HIST_BUCKETS) b = METRIC_HIST_BUCKETS - 1;
+    __atomic_fetch_add(&m->buckets[b], 1, __ATOMIC_RELAXED);
+
+    /* Racy max is fine: a lost update only under-reports by one sample. */
+    if (v > __atomic_load_n(&m->value, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&m->value, v, __ATOMIC_RELAXED);
+    }
+}
+
+/* Prints every registered metric to stdout, one per line. */
+void metrics_dump(void);
@@ -3,11 +3,22 @@
 #include <stdbool.h>
 #include "freertos/semphr.h"
 #include "app_types.h"
+#include "summary_record.h"
 
 bool sd_logger_init(SemaphoreHandle_t sd_mutex);
 bool sd_logger_write_sample(const sensor_sample_t *s);
 bool sd_logger_write_text(const char *text);
+/* Writes straight to the file, ahead of anything still buffered. */
+bool sd_logger_write_header(SemaphoreHandle_t sd_mutex, const char *text);
+bool sd_logger_write_summary(SemaphoreHandle_t sd_mutex, const summary_record_t *r);
 bool sd_logger_flush(SemaphoreHandle_t sd_mutex);
+/* Flush plus fsync: everything written so far survives a power cut. */
+bool sd_logger_sync(SemaphoreHandle_t sd_mutex);
+/*
+ * fsync of what is already in the file, leaving the RAM buffer alone. Safe
+ * from tasks other than logger_task, which alone owns the buffer.
+ */
+bool sd_logger_sync_file(SemaphoreHandle_t sd_mutex);
 void sd_logger_close(SemaphoreHandle_t sd_mutex);
 
 bool sd_logger_is_ready(void);
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/*
+ * Common I2C sensor plumbing. A driver describes its chip with const tables
+ * (ID register, init sequence, sample frame) and keeps only the chip-specific
+ * maths. Adding a sensor is a sensor_driver_t, its register blocks and a
+ * frame X-macro; the bus work below is shared.
+ */
+
+#define SENSOR_MAX_BURST        16      // registers per block (write and readback)
+#define SENSOR_ARRAY_LEN(a)     (sizeof(a) / sizeof((a)[0]))
+
+/* How a device accepts several registers in one write transaction. */
+typedef enum
+{
+    SENSOR_BURST_AUTOINC = 0,   // [reg][v0][v1]... address increments (MPU-6050)
+    SENSOR_BURST_PAIRS,         // [reg0][v0][reg1][v1]... explicit addresses (BMP280)
+} sensor_burst_t;
+
+typedef struct
+{
+    uint8_t reg;
+    uint8_t val;
+} sensor_reg_write_t;
+
+/*
+ * One bus transaction. For AUTOINC devices the registers must be consecutive
+ * and ascending; PAIRS devices take them in table order. With `verify`, the
+ * span the block touched is read back in one burst and compared.
+ */
+typedef struct
+{
+    const sensor_reg_write_t *writes;
+    uint8_t count;
+    bool verify;
+} sensor_reg_block_t;
+
+typedef struct
+{
+    const sensor_reg_block_t *blocks;
+    uint8_t count;
+} sensor_seq_t;
+
+typedef struct
+{
+    const char *name;
+    uint8_t addr7;
+    sensor_burst_t burst;
+
+    uint8_t id_reg;
+    uint8_t id_val;
+
+    sensor_seq_t init;      // run by sensor_driver_init() after the ID check
+
+    uint8_t frame_reg;      // sample frame: one burst read from here
+    uint8_t frame_len;
+} sensor_driver_t;
+
+/* Bus must be held by the caller. */
+bool sensor_driver_check_id(const sensor_driver_t *dev, TickType_t deadline);
+bool sensor_driver_write_seq(const sensor_driver_t *dev, const sensor_seq_t *seq, TickType_t deadline);
+
+/* Locks the bus, checks the ID and runs dev->init within I2C_INIT_TIMEOUT_MS. */
+bool sensor_driver_init(const sensor_driver_t *dev, SemaphoreHandle_t i2c_mutex);
+
+/* Locks the bus and reads dev->frame_len bytes from dev->frame_reg into raw. */
+bool sensor_driver_read_frame(const sensor_driver_t *dev, uint8_t *raw, SemaphoreHandle_t i2c_mutex, TickType_t deadline);
+
+/* ---- frame decoding ---------------------------------------------------- */
+
+static inline int32_t sensor_be16s(const uint8_t *p) { return (int16_t)((p[0] << 8) | p[1]); }
+static inline int32_t sensor_le16u(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline int32_t sensor_le16s(const uint8_t *p) { return (int16_t)(p[0] | (p[1] << 8)); }
+static inline int32_t sensor_be20u(const uint8_t *p) { return (int32_t)((p[0] << 12) | (p[1] << 4) | (p[2] >> 4)); }
+
+#define SENSOR_SIZEOF_be16s     2
+#define SENSOR_SIZEOF_le16u     2
+#define SENSOR_SIZEOF_le16s     2
+#define SENSOR_SIZEOF_be20u     3
+
+/*
+ * A frame layout is an X-macro of X(field, byte_offset, decoder) entries.
+ * SENSOR_DEFINE_UNPACKER turns it into a straight-line decoder with no
+ * loops or tables, and checks at compile time that every field lies inside
+ * the frame:
+ *
+ *   #define MY_FRAME(X)  X(ax, 0, be16s)  X(ay, 2, be16s)
+ *   SENSOR_DEFINE_UNPACKER(my_unpack, MY_FRAME, sensor_sample_t, 4)
+ */
+#define SENSOR_UNPACK_FIELD(field, off, dec) \
+    _Static_assert((off) + SENSOR_SIZEOF_##dec <= FRAME_LEN_, #field " outside frame"); \
+    out->field = (__typeof__(out->field))sensor_##dec(&raw[off]);
+
+#define SENSOR_DEFINE_UNPACKER(fn, FRAME, out_t, frame_len)                 \
+    static inline void fn(const uint8_t *raw, out_t *out)                  \
+    {                                                                       \
+        enum { FRAME_LEN_ = (frame_len) };                                  \
+        FRAME(SENSOR_UNPACK_FIELD)                                          \
+    }
@@ -1,2 +1,3 @@
 #pragma once
 void sensor_task(void *arg);
+void sensor_recovery_task(void *arg);
@@ -0,0 +1,24 @@
+#pragma once
+
+/*
+ * Raw-count scaling for the ranges imu_init() configures (±2 g, ±250 dps).
+ * Pure C so the host tools can share it; change together with imu_driver.c.
+ */
+
+#include <math.h>
+
+#define IMU_ACCEL_FULL_SCALE_G      2
+#define IMU_ACCEL_LSB_PER_G         (32768.0f / IMU_ACCEL_FULL_SCALE_G)
+#define IMU_GYRO_LSB_PER_DPS        131.0f
+
+// int16 rails; a raw value at either end means the axis is clipped
+#define IMU_RAW_SAT_POS             32767
+#define IMU_RAW_SAT_NEG             (-32768)
+
+#define BARO_SEA_LEVEL_PA           101325.0f
+
+/* International barometric formula, metres above the p0 reference. */
+static inline float baro_altitude_m(float pressure_pa, float p0_pa)
+{
+    return 44330.0f * (1.0f - powf(pressure_pa / p0_pa, 0.190295f));
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+ * On-card layout of the per-window summary file (SD_SUMMARY_FILENAME).
+ * A flat sequence of fixed-size little-endian records, no file header;
+ * shared with tools/flight_summary, so keep it free of ESP-IDF includes.
+ */
+
+#include <stdint.h>
+
+#define SUMMARY_MAGIC       0x314D5346u    // "FSM1"
+
+enum
+{
+    SUM_AX = 0,
+    SUM_AY,
+    SUM_AZ,
+    SUM_GX,
+    SUM_GY,
+    SUM_GZ,
+    SUM_PRESSURE,
+    SUMMARY_CHANNELS
+};
+
+#define SUMMARY_IMU_AXES    6
+
+typedef struct __attribute__((packed))
+{
+    int32_t min;
+    int32_t max;
+    float   mean;
+    float   var;        // population variance over the window
+} summary_channel_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint32_t t_start_ms;
+    uint32_t t_end_ms;      // last sample folded in
+    uint16_t n_imu;         // samples with imu_ok
+    uint16_t n_baro;        // samples with baro_ok
+    uint16_t saturated[SUMMARY_IMU_AXES];  // samples at the int16 rails, per axis
+    summary_channel_t ch[SUMMARY_CHANNELS];
+} summary_record_t;
+
+_Static_assert(sizeof(summary_record_t) == 140, "summary_record_t layout changed");
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdbool.h>
+#include "app_types.h"
+#include "summary_record.h"
+
+/*
+ * Streaming per-window min/max/mean/variance (Welford) over the raw sample
+ * channels, plus IMU saturation counts. Owned by logger_task; not thread-safe.
+ *
+ * Folds one sample in. When the sample falls past the current window, the
+ * finished window is written to *out first and true is returned.
+ */
+bool summary_stats_add(const sensor_sample_t *s, summary_record_t *out);
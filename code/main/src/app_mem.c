@@ -0,0 +1,191 @@
+#include "app_mem.h"
+
+#include <stdlib.h>
+
+#include "app_config.h"
+#include "app_types.h"
+
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "app_mem";
+
+/*
+ * The *CreateStatic calls below only exist when FreeRTOS is built with static
+ * allocation; fail here rather than at link time with no hint why.
+ */
+#if APP_STATIC_ALLOCATION && !configSUPPORT_STATIC_ALLOCATION
+#error "APP_STATIC_ALLOCATION needs configSUPPORT_STATIC_ALLOCATION (enable it in sdkconfig or build with APP_STATIC_ALLOCATION=0)"
+#endif
+
+#define APP_MEM_MAX_TASKS   8
+#define ARENA_ALIGN         16
+#define ARENA_ROUND(n)      (((size_t)(n) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+
+#define ARENA_TASK_BYTES(depth) \
+    (ARENA_ROUND(sizeof(StaticTask_t)) + ARENA_ROUND((size_t)(depth) * sizeof(StackType_t)))
+
+#define ARENA_QUEUE_BYTES(len, item) \
+    (ARENA_ROUND(sizeof(StaticQueue_t)) + ARENA_ROUND((size_t)(len) * (item)))
+
+/*
+ * Arena size is the exact sum of what app_init() and the modules ask for.
+ * If I add a task, queue or buffer, it has to be added here as well; an
+ * undersized arena trips the configASSERT in arena_alloc() on the first boot.
+ */
+#define APP_ARENA_SIZE_BYTES ( \
+    ARENA_TASK_BYTES(SENSOR_TASK_STACK_WORDS) + \
+    ARENA_TASK_BYTES(LOGGER_TASK_STACK_WORDS) + \
+    ARENA_TASK_BYTES(STATUS_TASK_STACK_WORDS) + \
+    ARENA_TASK_BYTES(I2C_RECOVERY_TASK_STACK_WORDS) + \
+    ARENA_QUEUE_BYTES(SENSOR_QUEUE_LENGTH, sizeof(sensor_sample_t)) + \
+    ARENA_QUEUE_BYTES(EVENT_QUEUE_LENGTH, sizeof(flight_event_t)) + \
+    2 * ARENA_ROUND(sizeof(StaticSemaphore_t)) + \
+    ARENA_ROUND(sizeof(StaticEventGroup_t)) + \
+    ARENA_ROUND(SD_BUFFER_SIZE_BYTES) )
+
+typedef struct
+{
+    TaskHandle_t handle;
+    const char *name;
+    uint32_t stack_depth;
+} tracked_task_t;
+
+static tracked_task_t s_tasks[APP_MEM_MAX_TASKS];
+static size_t s_task_count = 0;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#if APP_STATIC_ALLOCATION
+static uint8_t s_arena[APP_ARENA_SIZE_BYTES] __attribute__((aligned(ARENA_ALIGN)));
+static size_t s_arena_used = 0;
+
+static void *arena_alloc(size_t size)
+{
+    size_t n = ARENA_ROUND(size);
+    void *p = NULL;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_arena_used + n <= sizeof(s_arena)) {
+        p = &s_arena[s_arena_used];
+        s_arena_used += n;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    configASSERT(p != NULL);
+    return p;
+}
+#endif
+
+static void track_task(TaskHandle_t h, const char *name, uint32_t stack_depth)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (h && s_task_count < APP_MEM_MAX_TASKS) {
+        s_tasks[s_task_count].handle = h;
+        s_tasks[s_task_count].name = name;
+        s_tasks[s_task_count].stack_depth = stack_depth;
+        s_task_count++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void *app_mem_alloc(size_t size)
+{
+#if APP_STATIC_ALLOCATION
+    return arena_alloc(size);
+#else
+    return heap_caps_malloc(size, MALLOC_CAP_8BIT);
+#endif
+}
+
+TaskHandle_t app_mem_create_task(TaskFunction_t fn, const char *name, uint32_t stack_depth, UBaseType_t prio)
+{
+    TaskHandle_t h = NULL;
+
+#if APP_STATIC_ALLOCATION
+    StaticTask_t *tcb = arena_alloc(sizeof(StaticTask_t));
+    StackType_t *stack = arena_alloc((size_t)stack_depth * sizeof(StackType_t));
+    h = xTaskCreateStatic(fn, name, stack_depth, NULL, prio, stack, tcb);
+#else
+    if (xTaskCreate(fn, name, stack_depth, NULL, prio, &h) != pdPASS) {
+        h = NULL;
+    }
+#endif
+
+    if (!h) {
+        ESP_LOGE(TAG, "failed to create task %s", name);
+    }
+
+    track_task(h, name, stack_depth);
+    return h;
+}
+
+QueueHandle_t app_mem_create_queue(UBaseType_t length, UBaseType_t item_size)
+{
+#if APP_STATIC_ALLOCATION
+    StaticQueue_t *q = arena_alloc(sizeof(StaticQueue_t));
+    uint8_t *storage = arena_alloc((size_t)length * item_size);
+    return xQueueCreateStatic(length, item_size, storage, q);
+#else
+    return xQueueCreate(length, item_size);
+#endif
+}
+
+SemaphoreHandle_t app_mem_create_mutex(void)
+{
+#if APP_STATIC_ALLOCATION
+    return xSemaphoreCreateMutexStatic(arena_alloc(sizeof(StaticSemaphore_t)));
+#else
+    return xSemaphoreCreateMutex();
+#endif
+}
+
+EventGroupHandle_t app_mem_create_event_group(void)
+{
+#if APP_STATIC_ALLOCATION
+    return xEventGroupCreateStatic(arena_alloc(sizeof(StaticEventGroup_t)));
+#else
+    return xEventGroupCreate();
+#endif
+}
+
+size_t app_mem_arena_used(void)
+{
+#if APP_STATIC_ALLOCATION
+    return s_arena_used;
+#else
+    return 0;
+#endif
+}
+
+size_t app_mem_arena_capacity(void)
+{
+#if APP_STATIC_ALLOCATION
+    return sizeof(s_arena);
+#else
+    return 0;
+#endif
+}
+
+void app_mem_report(void)
+{
+    ESP_LOGI(TAG, "arena used=%u/%u bytes",
+             (unsigned)app_mem_arena_used(), (unsigned)app_mem_arena_capacity());
+
+    /*
+     * High-water mark is the least free stack seen so far, in the same unit as
+     * the depth passed at creation. Stack sizes can be trimmed against this
+     * after a representative run (SD remounts included).
+     */
+    for (size_t i = 0; i < s_task_count; i++) {
+        ESP_LOGI(TAG, "%s stack free_min=%u/%u",
+                 s_tasks[i].name,
+                 (unsigned)uxTaskGetStackHighWaterMark(s_tasks[i].handle),
+                 (unsigned)s_tasks[i].stack_depth);
+    }
+
+    ESP_LOGI(TAG, "heap free=%u min_free=%u largest_block=%u",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
@@ -1,9 +1,11 @@
 #include "baro_driver.h"
 
 #include "app_config.h"
-#include "driver/i2c.h"
+#include "i2c_bus.h"
+#include "sensor_driver.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
 
-#include <string.h>
 #include <stdint.h>
 
 #define BMP_REG_ID          0xD0
@@ -14,6 +16,9 @@
 #define BMP_REG_PRESS_MSB   0xF7
 #define BMP_REG_CALIB00     0x88
 
+#define BMP_CALIB_LEN       24
+#define BMP_FRAME_LEN       6
+
 typedef struct
 {
     uint16_t dig_T1;
@@ -31,57 +36,87 @@ typedef struct
     int16_t  dig_P9;
 } bmp280_calib_t;
 
-static bmp280_calib_t s_calib;
-static int32_t s_tfine = 0;
-
-static bool i2c_read_reg(uint8_t addr7, uint8_t reg, uint8_t *buf, size_t len)
-{
-    esp_err_t err = i2c_master_write_read_device(
-        I2C_PORT_NUM,
-        addr7,
-        &reg, 1,
-        buf, len,
-        pdMS_TO_TICKS(50)
-    );
-    return err == ESP_OK;
-}
-
-static bool i2c_write_reg(uint8_t addr7, uint8_t reg, uint8_t val)
+typedef struct
 {
-    uint8_t pkt[2] = { reg, val };
-    esp_err_t err = i2c_master_write_to_device(
-        I2C_PORT_NUM,
-        addr7,
-        pkt, sizeof(pkt),
-        pdMS_TO_TICKS(50)
-    );
-    return err == ESP_OK;
-}
+    int32_t adc_P;
+    int32_t adc_T;
+} bmp280_raw_t;
+
+/* Calibration NVM at 0x88..0x9F, little-endian. */
+#define BMP_CALIB_FRAME(X)  \
+    X(dig_T1,  0, le16u)    \
+    X(dig_T2,  2, le16s)    \
+    X(dig_T3,  4, le16s)    \
+    X(dig_P1,  6, le16u)    \
+    X(dig_P2,  8, le16s)    \
+    X(dig_P3, 10, le16s)    \
+    X(dig_P4, 12, le16s)    \
+    X(dig_P5, 14, le16s)    \
+    X(dig_P6, 16, le16s)    \
+    X(dig_P7, 18, le16s)    \
+    X(dig_P8, 20, le16s)    \
+    X(dig_P9, 22, le16s)
+
+/* press_msb..temp_xlsb, 20-bit big-endian with the low nibble in xlsb[7:4]. */
+#define BMP_FRAME(X)        \
+    X(adc_P, 0, be20u)      \
+    X(adc_T, 3, be20u)
+
+SENSOR_DEFINE_UNPACKER(bmp_unpack_calib, BMP_CALIB_FRAME, bmp280_calib_t, BMP_CALIB_LEN)
+SENSOR_DEFINE_UNPACKER(bmp_unpack, BMP_FRAME, bmp280_raw_t, BMP_FRAME_LEN)
+
+/* Soft reset; the register always reads back 0x00, so it is not verified. */
+static const sensor_reg_write_t k_bmp_reset[] = {
+    { BMP_REG_RESET, 0xB6 },
+};
+
+static const sensor_reg_block_t k_bmp_reset_seq[] = {
+    { k_bmp_reset, SENSOR_ARRAY_LEN(k_bmp_reset), false },
+};
+
+/*
+ * Flight logging config:
+ * - normal mode (continuous)
+ * - modest oversampling to reduce noise without dragging latency
+ * This is not tuned yet; it’s a stable starting point.
+ *
+ * CONFIG goes first: in normal mode writes to it may be ignored, and
+ * CTRL_MEAS is what leaves sleep. The BMP280 has no auto-increment on
+ * writes, so both go as reg/value pairs in one transaction.
+ */
+static const sensor_reg_write_t k_bmp_config[] = {
+    { BMP_REG_CONFIG,    0x08 },    // filter=2, standby=0.5ms
+    { BMP_REG_CTRL_MEAS, 0x27 },    // osrs_t=1, osrs_p=1, mode=normal
+};
+
+static const sensor_reg_block_t k_bmp_config_blocks[] = {
+    { k_bmp_config, SENSOR_ARRAY_LEN(k_bmp_config), true },
+};
+
+static const sensor_seq_t k_bmp_config_seq = { k_bmp_config_blocks, SENSOR_ARRAY_LEN(k_bmp_config_blocks) };
+
+static const sensor_driver_t k_bmp280 = {
+    .name = "bmp280",
+    .addr7 = BMP280_I2C_ADDR,
+    .burst = SENSOR_BURST_PAIRS,
+    .id_reg = BMP_REG_ID,
+    .id_val = 0x58,
+    .init = { k_bmp_reset_seq, SENSOR_ARRAY_LEN(k_bmp_reset_seq) },
+    .frame_reg = BMP_REG_PRESS_MSB,
+    .frame_len = BMP_FRAME_LEN,
+};
 
-static uint16_t u16le(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
-static int16_t  s16le(const uint8_t *p) { return (int16_t)(p[0] | (p[1] << 8)); }
+static bmp280_calib_t s_calib;
+static int32_t s_tfine = 0;
 
-static bool read_calibration(void)
+static bool read_calibration(TickType_t deadline)
 {
-    uint8_t c[24] = {0};
-    if (!i2c_read_reg(BMP280_I2C_ADDR, BMP_REG_CALIB00, c, sizeof(c))) {
+    uint8_t c[BMP_CALIB_LEN];
+    if (!i2c_bus_read_reg(BMP280_I2C_ADDR, BMP_REG_CALIB00, c, sizeof(c), deadline)) {
         return false;
     }
 
-    s_calib.dig_T1 = u16le(&c[0]);
-    s_calib.dig_T2 = s16le(&c[2]);
-    s_calib.dig_T3 = s16le(&c[4]);
-
-    s_calib.dig_P1 = u16le(&c[6]);
-    s_calib.dig_P2 = s16le(&c[8]);
-    s_calib.dig_P3 = s16le(&c[10]);
-    s_calib.dig_P4 = s16le(&c[12]);
-    s_calib.dig_P5 = s16le(&c[14]);
-    s_calib.dig_P6 = s16le(&c[16]);
-    s_calib.dig_P7 = s16le(&c[18]);
-    s_calib.dig_P8 = s16le(&c[20]);
-    s_calib.dig_P9 = s16le(&c[22]);
-
+    bmp_unpack_calib(c, &s_calib);
     return true;
 }
 
@@ -125,59 +160,57 @@ static uint32_t compensate_press_pa(int32_t adc_P)
     return (uint32_t)(p >> 8); // Pa
 }
 
-bool baro_init(SemaphoreHandle_t i2c_mutex)
-{
-    xSemaphoreTake(i2c_mutex, portMAX_DELAY);
+/*
+ * BMP280 needs ~2 ms after a soft reset before its NVM (calibration) is
+ * readable. Reset and configure are split so the boot path can bring the
+ * IMU up inside that window instead of sleeping through it.
+ */
+#define BMP_STARTUP_US      2000
 
-    uint8_t id = 0;
-    if (!i2c_read_reg(BMP280_I2C_ADDR, BMP_REG_ID, &id, 1)) {
-        xSemaphoreGive(i2c_mutex);
-        return false;
-    }
+static int64_t s_reset_us = 0;
 
-    if (id != 0x58) { // BMP280 chip ID
-        xSemaphoreGive(i2c_mutex);
-        return false;
+bool baro_reset(SemaphoreHandle_t i2c_mutex)
+{
+    bool ok = sensor_driver_init(&k_bmp280, i2c_mutex);
+    s_reset_us = esp_timer_get_time();
+    return ok;
+}
+
+bool baro_configure(SemaphoreHandle_t i2c_mutex)
+{
+    /* Busy-wait is fine here: at most 2 ms, and a tick is usually longer. */
+    int64_t since_reset = esp_timer_get_time() - s_reset_us;
+    if (since_reset < BMP_STARTUP_US) {
+        esp_rom_delay_us((uint32_t)(BMP_STARTUP_US - since_reset));
     }
 
-    (void)i2c_write_reg(BMP280_I2C_ADDR, BMP_REG_RESET, 0xB6);
+    TickType_t deadline = i2c_bus_deadline_in(I2C_INIT_TIMEOUT_MS);
+    if (!i2c_bus_lock(i2c_mutex, deadline)) return false;
 
-    if (!read_calibration()) {
-        xSemaphoreGive(i2c_mutex);
-        return false;
-    }
+    bool ok = read_calibration(deadline) &&
+              sensor_driver_write_seq(&k_bmp280, &k_bmp_config_seq, deadline);
 
-    /*
-     * Flight logging config:
-     * - normal mode (continuous)
-     * - modest oversampling to reduce noise without dragging latency
-     * This is not tuned yet; it’s a stable starting point.
-     */
-    (void)i2c_write_reg(BMP280_I2C_ADDR, BMP_REG_CONFIG, 0x08);     // filter=2, standby=0.5ms
-    (void)i2c_write_reg(BMP280_I2C_ADDR, BMP_REG_CTRL_MEAS, 0x27);  // osrs_t=1, osrs_p=1, mode=normal
+    i2c_bus_unlock(i2c_mutex);
+    return ok;
+}
 
-    xSemaphoreGive(i2c_mutex);
-    return true;
+bool baro_init(SemaphoreHandle_t i2c_mutex)
+{
+    return baro_reset(i2c_mutex) && baro_configure(i2c_mutex);
 }
 
-bool baro_read_pressure(sensor_sample_t *sample, SemaphoreHandle_t i2c_mutex)
+bool baro_read_pressure(sensor_sample_t *sample, SemaphoreHandle_t i2c_mutex, TickType_t deadline)
 {
     if (!sample) return false;
 
-    xSemaphoreTake(i2c_mutex, portMAX_DELAY);
-
-    uint8_t d[6] = {0};
-    bool ok = i2c_read_reg(BMP280_I2C_ADDR, BMP_REG_PRESS_MSB, d, sizeof(d));
-
-    xSemaphoreGive(i2c_mutex);
-
-    if (!ok) return false;
+    uint8_t d[BMP_FRAME_LEN];
+    if (!sensor_driver_read_frame(&k_bmp280, d, i2c_mutex, deadline)) return false;
 
-    int32_t adc_P = (int32_t)((d[0] << 12) | (d[1] << 4) | (d[2] >> 4));
-    int32_t adc_T = (int32_t)((d[3] << 12) | (d[4] << 4) | (d[5] >> 4));
+    bmp280_raw_t raw;
+    bmp_unpack(d, &raw);
 
-    (void)compensate_temp_x100(adc_T);                 // updates s_tfine
-    sample->pressure_pa = (int32_t)compensate_press_pa(adc_P);
+    (void)compensate_temp_x100(raw.adc_T);             // updates s_tfine
+    sample->pressure_pa = (int32_t)compensate_press_pa(raw.adc_P);
 
     return true;
 }
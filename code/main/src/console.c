@@ -0,0 +1,150 @@
+#include "console.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "app_config.h"
+#include "app_mem.h"
+#include "metrics.h"
+#include "log_download.h"
+#include "i2c_bus.h"
+
+#include "driver/uart.h"
+
+#define CONSOLE_LINE_MAX    32
+#define CONSOLE_RX_BUFFER   1024    // also covers a window of download ACKs
+#define CONSOLE_MAX_TASKS   32      // IDF system tasks + ours, with headroom
+
+static char s_line[CONSOLE_LINE_MAX];
+static size_t s_line_len = 0;
+
+static void cmd_help(void)
+{
+#if I2C_BUS_FAULT_INJECTION
+    printf("commands: metrics | tasks | mem | download | fault <imu|baro> <nack|hang|none> [count] | help\n");
+#else
+    printf("commands: metrics | tasks | mem | download | help\n");
+#endif
+}
+
+#if I2C_BUS_FAULT_INJECTION
+/*
+ * Bench-only: "fault imu hang 10" makes the next 10 IMU transfers block to
+ * their deadline. A count below SENSOR_FAIL_THRESHOLD shows single missed
+ * samples; a larger one drives the sensor into the recovery task.
+ */
+static void cmd_fault(const char *args)
+{
+    char dev[8], kind[8];
+    unsigned long count = 1;
+
+    int n = sscanf(args, "%7s %7s %lu", dev, kind, &count);
+    if (n < 2) {
+        cmd_help();
+        return;
+    }
+
+    uint8_t addr;
+    if (strcmp(dev, "imu") == 0)       addr = MPU_I2C_ADDR;
+    else if (strcmp(dev, "baro") == 0) addr = BMP280_I2C_ADDR;
+    else {
+        cmd_help();
+        return;
+    }
+
+    i2c_fault_t fault;
+    if (strcmp(kind, "nack") == 0)      fault = I2C_FAULT_NACK;
+    else if (strcmp(kind, "hang") == 0) fault = I2C_FAULT_HANG;
+    else if (strcmp(kind, "none") == 0) fault = I2C_FAULT_NONE;
+    else {
+        cmd_help();
+        return;
+    }
+
+    i2c_bus_inject_fault(addr, fault, (uint32_t)count);
+    printf("fault: %s %s x%lu\n", dev, kind, count);
+}
+#endif
+
+static void cmd_tasks(void)
+{
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+    /* Static so a dump does not need status_task's stack to grow. */
+    static TaskStatus_t s_status[CONSOLE_MAX_TASKS];
+
+    /* uxTaskGetSystemState() returns nothing at all if the array is short. */
+    UBaseType_t want = uxTaskGetNumberOfTasks();
+    if (want > CONSOLE_MAX_TASKS) {
+        printf("tasks: %u running, only room for %u\n", (unsigned)want, (unsigned)CONSOLE_MAX_TASKS);
+        return;
+    }
+
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(s_status, CONSOLE_MAX_TASKS, &total);
+    if (n == 0) {
+        printf("tasks: no snapshot (task count changed, try again)\n");
+        return;
+    }
+
+    /* Run-time counters are cumulative since boot. */
+    uint32_t pct_div = total / 100;
+    if (pct_div == 0) pct_div = 1;
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        printf("task    %-16s cpu=%3lu%% prio=%u stack_free_min=%lu\n",
+               s_status[i].pcTaskName,
+               (unsigned long)(s_status[i].ulRunTimeCounter / pct_div),
+               (unsigned)s_status[i].uxCurrentPriority,
+               (unsigned long)s_status[i].usStackHighWaterMark);
+    }
+#else
+    printf("tasks: enable CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and CONFIG_FREERTOS_USE_TRACE_FACILITY\n");
+#endif
+}
+
+static void run_line(const char *line)
+{
+    if (line[0] == '\0') return;
+
+    if (strcmp(line, "metrics") == 0 || strcmp(line, "m") == 0) {
+        metrics_dump();
+    } else if (strcmp(line, "tasks") == 0 || strcmp(line, "t") == 0) {
+        cmd_tasks();
+    } else if (strcmp(line, "mem") == 0) {
+        app_mem_report();
+    } else if (strcmp(line, "download") == 0) {
+        log_download_serve();
+#if I2C_BUS_FAULT_INJECTION
+    } else if (strncmp(line, "fault ", 6) == 0) {
+        cmd_fault(line + 6);
+#endif
+    } else {
+        cmd_help();
+    }
+}
+
+void console_init(void)
+{
+    if (!uart_is_driver_installed(CONSOLE_UART_NUM)) {
+        (void)uart_driver_install(CONSOLE_UART_NUM, CONSOLE_RX_BUFFER, 0, 0, NULL, 0);
+    }
+}
+
+void console_poll(void)
+{
+    uint8_t c;
+
+    while (uart_read_bytes(CONSOLE_UART_NUM, &c, 1, 0) == 1)
+    {
+        if (c == '\r' || c == '\n') {
+            s_line[s_line_len] = '\0';
+            run_line(s_line);
+            s_line_len = 0;
+        } else if (s_line_len < CONSOLE_LINE_MAX - 1) {
+            s_line[s_line_len++] = (char)c;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#include "event_log.h"
+
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include "app_init.h"
+#include "metrics.h"
+#include "esp_timer.h"
+
+static metric_t *m_posted;
+static metric_t *m_dropped;
+
+static const char *type_name(uint8_t type)
+{
+    switch (type) {
+    case FLIGHT_EVT_SENSOR_UP:      return "sensor_up";
+    case FLIGHT_EVT_SENSOR_DOWN:    return "sensor_down";
+    case FLIGHT_EVT_SD_MOUNTED:     return "sd_mounted";
+    case FLIGHT_EVT_SD_LOST:        return "sd_lost";
+    case FLIGHT_EVT_OVERFLOW_BURST: return "overflow_burst";
+    case FLIGHT_EVT_LAUNCH:         return "launch";
+    default:                        return "unknown";
+    }
+}
+
+void event_log_init(void)
+{
+    m_posted  = metrics_counter("events.posted");
+    m_dropped = metrics_counter("events.dropped");
+}
+
+bool event_log_post(flight_event_type_t type, int32_t arg)
+{
+    flight_event_t e = {
+        .t_ms = (uint32_t)(esp_timer_get_time() / 1000),
+        .type = (uint8_t)type,
+        .arg  = arg,
+    };
+
+    if (xQueueSend(event_queue, &e, 0) != pdTRUE) {
+        metrics_inc(m_dropped);
+        return false;
+    }
+
+    metrics_inc(m_posted);
+    return true;
+}
+
+int event_log_format(const flight_event_t *e, char *buf, size_t len)
+{
+    if (e->type == FLIGHT_EVT_SENSOR_UP || e->type == FLIGHT_EVT_SENSOR_DOWN) {
+        return snprintf(buf, len, "# evt t_ms=%lu type=%s sensor=%s\n",
+                        (unsigned long)e->t_ms, type_name(e->type),
+                        e->arg == FLIGHT_SENSOR_IMU ? "imu" : "baro");
+    }
+
+    return snprintf(buf, len, "# evt t_ms=%lu type=%s arg=%ld\n",
+                    (unsigned long)e->t_ms, type_name(e->type), (long)e->arg);
+}
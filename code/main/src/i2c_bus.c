@@ -0,0 +1,197 @@
+#include "i2c_bus.h"
+
+#include "freertos/task.h"
+
+#include "driver/i2c.h"
+#include "driver/gpio.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+
+static const char *TAG = "i2c_bus";
+
+static void driver_install(void)
+{
+    i2c_config_t cfg = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = I2C_SDA_GPIO,
+        .scl_io_num = I2C_SCL_GPIO,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = I2C_FREQ_HZ,
+        .clk_flags = 0
+    };
+
+    (void)i2c_param_config(I2C_PORT_NUM, &cfg);
+    (void)i2c_driver_install(I2C_PORT_NUM, cfg.mode, 0, 0, 0);
+}
+
+void i2c_bus_init(void)
+{
+    driver_install();
+}
+
+TickType_t i2c_bus_deadline_in(uint32_t ms)
+{
+    /*
+     * At the default 100 Hz tick a few-ms budget rounds to zero ticks, so I
+     * always allow at least one tick. The deadline is therefore only as fine
+     * as the tick; the per-transfer cap still bounds the worst case.
+     */
+    TickType_t ticks = pdMS_TO_TICKS(ms);
+    if (ticks == 0) ticks = 1;
+    return xTaskGetTickCount() + ticks;
+}
+
+/* Ticks left before `deadline`, 0 if it has passed. Wrap-safe. */
+static TickType_t remaining(TickType_t deadline)
+{
+    int32_t left = (int32_t)(deadline - xTaskGetTickCount());
+    return left > 0 ? (TickType_t)left : 0;
+}
+
+static TickType_t xfer_timeout(TickType_t deadline)
+{
+    TickType_t left = remaining(deadline);
+    TickType_t cap = pdMS_TO_TICKS(I2C_XFER_TIMEOUT_MS);
+    return left < cap ? left : cap;
+}
+
+bool i2c_bus_lock(SemaphoreHandle_t i2c_mutex, TickType_t deadline)
+{
+    return xSemaphoreTake(i2c_mutex, remaining(deadline)) == pdTRUE;
+}
+
+void i2c_bus_unlock(SemaphoreHandle_t i2c_mutex)
+{
+    xSemaphoreGive(i2c_mutex);
+}
+
+#if I2C_BUS_FAULT_INJECTION
+static volatile uint8_t s_fault_addr = 0;
+static volatile i2c_fault_t s_fault = I2C_FAULT_NONE;
+static volatile uint32_t s_fault_count = 0;
+
+void i2c_bus_inject_fault(uint8_t addr7, i2c_fault_t fault, uint32_t count)
+{
+    s_fault_addr = addr7;
+    s_fault_count = count;
+    s_fault = fault;
+}
+
+/* Returns true if this transfer was consumed by an injected fault. */
+static bool fault_hit(uint8_t addr7, TickType_t deadline)
+{
+    if (s_fault == I2C_FAULT_NONE || addr7 != s_fault_addr || s_fault_count == 0) {
+        return false;
+    }
+
+    if (s_fault == I2C_FAULT_HANG) {
+        vTaskDelay(xfer_timeout(deadline));
+    }
+
+    if (--s_fault_count == 0) {
+        s_fault = I2C_FAULT_NONE;
+    }
+    return true;
+}
+#endif
+
+bool i2c_bus_read_reg(uint8_t addr7, uint8_t reg, uint8_t *buf, size_t len, TickType_t deadline)
+{
+    TickType_t timeout = xfer_timeout(deadline);
+    if (timeout == 0) return false;
+
+#if I2C_BUS_FAULT_INJECTION
+    if (fault_hit(addr7, deadline)) return false;
+#endif
+
+    esp_err_t err = i2c_master_write_read_device(
+        I2C_PORT_NUM,
+        addr7,
+        &reg, 1,
+        buf, len,
+        timeout
+    );
+    return err == ESP_OK;
+}
+
+bool i2c_bus_write(uint8_t addr7, const uint8_t *data, size_t len, TickType_t deadline)
+{
+    TickType_t timeout = xfer_timeout(deadline);
+    if (timeout == 0) return false;
+
+#if I2C_BUS_FAULT_INJECTION
+    if (fault_hit(addr7, deadline)) return false;
+#endif
+
+    esp_err_t err = i2c_master_write_to_device(
+        I2C_PORT_NUM,
+        addr7,
+        data, len,
+        timeout
+    );
+    return err == ESP_OK;
+}
+
+/*
+ * Standard I2C bus clear: a slave stuck mid-byte holds SDA low until it has
+ * clocked out the rest of that byte, so up to 9 SCL pulses release it. A STOP
+ * afterwards puts every device back to idle.
+ */
+static bool clear_bus(void)
+{
+    gpio_config_t io = {
+        .pin_bit_mask = (1ULL << I2C_SCL_GPIO) | (1ULL << I2C_SDA_GPIO),
+        .mode = GPIO_MODE_INPUT_OUTPUT_OD,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
+    };
+    (void)gpio_config(&io);
+
+    (void)gpio_set_level(I2C_SDA_GPIO, 1);
+    (void)gpio_set_level(I2C_SCL_GPIO, 1);
+    esp_rom_delay_us(5);
+
+    for (int i = 0; i < 9 && gpio_get_level(I2C_SDA_GPIO) == 0; i++) {
+        (void)gpio_set_level(I2C_SCL_GPIO, 0);
+        esp_rom_delay_us(5);
+        (void)gpio_set_level(I2C_SCL_GPIO, 1);
+        esp_rom_delay_us(5);
+    }
+
+    // STOP: SDA low -> high while SCL is high
+    (void)gpio_set_level(I2C_SCL_GPIO, 0);
+    (void)gpio_set_level(I2C_SDA_GPIO, 0);
+    esp_rom_delay_us(5);
+    (void)gpio_set_level(I2C_SCL_GPIO, 1);
+    esp_rom_delay_us(5);
+    (void)gpio_set_level(I2C_SDA_GPIO, 1);
+    esp_rom_delay_us(5);
+
+    return gpio_get_level(I2C_SDA_GPIO) == 1;
+}
+
+bool i2c_bus_recover(SemaphoreHandle_t i2c_mutex)
+{
+    /*
+     * A transfer in flight is capped at I2C_XFER_TIMEOUT_MS, so the mutex is
+     * always released within that; I allow a few multiples of it.
+     */
+    if (!i2c_bus_lock(i2c_mutex, i2c_bus_deadline_in(4 * I2C_XFER_TIMEOUT_MS))) {
+        ESP_LOGW(TAG, "recovery: bus still held");
+        return false;
+    }
+
+    (void)i2c_driver_delete(I2C_PORT_NUM);
+
+    bool sda_free = clear_bus();
+    driver_install();
+
+    i2c_bus_unlock(i2c_mutex);
+
+    if (!sda_free) {
+        ESP_LOGW(TAG, "recovery: SDA still held low");
+    }
+    return sda_free;
+}
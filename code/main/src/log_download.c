@@ -0,0 +1,181 @@
+#include "log_download.h"
+
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "app_init.h"
+#include "app_config.h"
+#include "log_download_core.h"
+#include "sd_logger.h"
+
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+/*
+ * Runs in status_task context, so everything large is static rather than on
+ * its stack. Only one session can exist at a time.
+ */
+static uint8_t s_tx_payload[LOGDL_MAX_PAYLOAD];
+static uint8_t s_rx_payload[LOGDL_MAX_PAYLOAD];
+
+static FILE *s_fp = NULL;
+
+static inline uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void send_frame(void *ctx, uint8_t type, uint8_t flags, uint32_t offset, const void *payload, uint16_t len)
+{
+    (void)ctx;
+    logdl_hdr_t h = {
+        .sync = { LOGDL_SYNC0, LOGDL_SYNC1 },
+        .type = type,
+        .flags = flags,
+        .offset = offset,
+        .len = len,
+    };
+    h.crc = logdl_frame_crc(&h, payload);
+
+    (void)uart_write_bytes(CONSOLE_UART_NUM, &h, sizeof(h));
+    if (len) (void)uart_write_bytes(CONSOLE_UART_NUM, payload, len);
+}
+
+static bool read_exact(void *dst, size_t n, TickType_t timeout)
+{
+    int got = uart_read_bytes(CONSOLE_UART_NUM, dst, n, timeout);
+    return got == (int)n;
+}
+
+/*
+ * Hunts for the sync bytes, then reads header + payload. Anything that fails
+ * its CRC is dropped silently; the host's retransmit logic covers it.
+ */
+static bool recv_frame(logdl_hdr_t *h, TickType_t timeout)
+{
+    uint8_t c;
+
+    do {
+        if (!read_exact(&c, 1, timeout)) return false;
+    } while (c != LOGDL_SYNC0);
+
+    if (!read_exact(&c, 1, timeout) || c != LOGDL_SYNC1) return false;
+
+    h->sync[0] = LOGDL_SYNC0;
+    h->sync[1] = LOGDL_SYNC1;
+    if (!read_exact(&h->type, sizeof(*h) - 2, timeout)) return false;
+
+    if (h->len > LOGDL_MAX_PAYLOAD) return false;
+    if (h->len && !read_exact(s_rx_payload, h->len, timeout)) return false;
+
+    return logdl_frame_crc(h, s_rx_payload) == h->crc;
+}
+
+static void close_file(void *ctx)
+{
+    (void)ctx;
+    if (!s_fp) return;
+
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+    fclose(s_fp);
+    xSemaphoreGive(sd_mutex);
+
+    s_fp = NULL;
+}
+
+/* The core has already checked the name and closed any previous file. */
+static logdl_err_t open_file(void *ctx, const uint8_t *name, uint16_t len, uint32_t *size)
+{
+    (void)ctx;
+    char path[sizeof(SD_MOUNT_POINT) + 1 + LOGDL_MAX_NAME + 1];
+
+    if (!sd_logger_is_ready()) return LOGDL_ERR_NO_CARD;
+
+    snprintf(path, sizeof(path), "%s/%.*s", SD_MOUNT_POINT, (int)len, (const char *)name);
+
+    /*
+     * The logger keeps its own append handle on flight.csv, and FATFS only
+     * updates the directory entry (which a second fopen reads the size from)
+     * on f_sync or close. Sync what the logger has written so far, then
+     * snapshot the size; its RAM buffer belongs to logger_task and is left
+     * alone, so anything still in it is picked up by the next OPEN.
+     */
+    (void)sd_logger_sync_file(sd_mutex);
+
+    *size = 0;
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+    s_fp = fopen(path, "rb");
+    if (s_fp && fseek(s_fp, 0, SEEK_END) == 0) {
+        long end = ftell(s_fp);
+        *size = end > 0 ? (uint32_t)end : 0;
+    }
+    xSemaphoreGive(sd_mutex);
+
+    return s_fp ? 0 : LOGDL_ERR_NOT_FOUND;
+}
+
+static const uint8_t *read_chunk(void *ctx, uint32_t offset, uint16_t len)
+{
+    (void)ctx;
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+    size_t got = 0;
+    if (fseek(s_fp, (long)offset, SEEK_SET) == 0) {
+        got = fread(s_tx_payload, 1, len, s_fp);
+    }
+    xSemaphoreGive(sd_mutex);
+
+    return got == len ? s_tx_payload : NULL;
+}
+
+static const logdl_io_t k_io = {
+    .open = open_file,
+    .close = close_file,
+    .read = read_chunk,
+    .send = send_frame,
+};
+
+/* The protocol itself lives in log_download_core.c; this only feeds it. */
+static void serve(void)
+{
+    static logdl_session_t s;
+    logdl_session_init(&s, &k_io, LOG_DL_WINDOW_CHUNKS * LOGDL_MAX_PAYLOAD,
+                       LOG_DL_ACK_TIMEOUT_MS, LOG_DL_IDLE_TIMEOUT_MS, now_ms());
+
+    while (1)
+    {
+        logdl_session_pump(&s, now_ms());
+
+        logdl_hdr_t h;
+        if (recv_frame(&h, pdMS_TO_TICKS(LOG_DL_POLL_MS))) {
+            if (!logdl_session_handle(&s, &h, s_rx_payload, now_ms())) return;
+        }
+
+        if (!logdl_session_tick(&s, now_ms())) return;
+    }
+}
+
+void log_download_serve(void)
+{
+    uint32_t console_baud = 0;
+    (void)uart_get_baudrate(CONSOLE_UART_NUM, &console_baud);
+
+    printf("download: switching to %u baud\n", (unsigned)LOG_DL_BAUD);
+    fflush(stdout);
+    (void)uart_wait_tx_done(CONSOLE_UART_NUM, pdMS_TO_TICKS(100));
+
+    /* Log output from other tasks would corrupt the binary stream. */
+    esp_log_level_set("*", ESP_LOG_NONE);
+    (void)uart_set_baudrate(CONSOLE_UART_NUM, LOG_DL_BAUD);
+    (void)uart_flush_input(CONSOLE_UART_NUM);
+
+    serve();
+
+    (void)uart_wait_tx_done(CONSOLE_UART_NUM, pdMS_TO_TICKS(100));
+    (void)uart_set_baudrate(CONSOLE_UART_NUM, console_baud);
+    esp_log_level_set("*", CONFIG_LOG_DEFAULT_LEVEL);
+
+    printf("download: done\n");
+}
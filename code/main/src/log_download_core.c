@@ -0,0 +1,120 @@
+#include "log_download_core.h"
+
+#include <string.h>
+
+void logdl_session_init(logdl_session_t *s, const logdl_io_t *io, uint32_t window_bytes,
+                        uint32_t ack_timeout_ms, uint32_t idle_timeout_ms, uint32_t now_ms)
+{
+    memset(s, 0, sizeof(*s));
+    s->io = io;
+    s->window_bytes = window_bytes;
+    s->ack_timeout_ms = ack_timeout_ms;
+    s->idle_timeout_ms = idle_timeout_ms;
+    s->last_rx_ms = now_ms;
+    s->last_progress_ms = now_ms;
+}
+
+void logdl_session_close(logdl_session_t *s)
+{
+    s->io->close(s->io->ctx);
+    s->active = false;
+}
+
+/* Plain file names only; the card root is the only directory served. */
+static bool name_ok(const uint8_t *name, uint16_t len)
+{
+    if (len == 0 || len > LOGDL_MAX_NAME) return false;
+    if (memchr(name, '/', len) || memchr(name, '\0', len)) return false;
+    return name[0] != '.';
+}
+
+void logdl_session_pump(logdl_session_t *s, uint32_t now_ms)
+{
+    /* Keep the window full; the link paces us at line rate. */
+    while (s->active && s->next < s->size && s->next - s->base < s->window_bytes) {
+        uint32_t left = s->size - s->next;
+        uint16_t n = (uint16_t)(left < LOGDL_MAX_PAYLOAD ? left : LOGDL_MAX_PAYLOAD);
+
+        const uint8_t *data = s->io->read(s->io->ctx, s->next, n);
+        if (!data) {
+            s->io->send(s->io->ctx, LOGDL_ERROR, LOGDL_ERR_IO, s->next, NULL, 0);
+            logdl_session_close(s);
+            return;
+        }
+
+        s->io->send(s->io->ctx, LOGDL_DATA, 0, s->next, data, n);
+        s->next += n;
+    }
+
+    if (s->active && s->base >= s->size && !s->done_sent) {
+        s->io->send(s->io->ctx, LOGDL_DONE, 0, s->size, NULL, 0);
+        s->done_sent = true;
+        s->last_progress_ms = now_ms;
+    }
+}
+
+bool logdl_session_handle(logdl_session_t *s, const logdl_hdr_t *h, const uint8_t *payload, uint32_t now_ms)
+{
+    s->last_rx_ms = now_ms;
+
+    switch (h->type) {
+    case LOGDL_OPEN: {
+        s->io->close(s->io->ctx);
+
+        logdl_err_t err = name_ok(payload, h->len) ? s->io->open(s->io->ctx, payload, h->len, &s->size)
+                                                   : LOGDL_ERR_BAD_NAME;
+        if (err) {
+            s->io->send(s->io->ctx, LOGDL_ERROR, err, 0, NULL, 0);
+            s->active = false;
+            break;
+        }
+        s->base = s->next = h->offset < s->size ? h->offset : s->size;
+        s->active = true;
+        s->done_sent = false;
+        s->last_progress_ms = now_ms;
+        s->io->send(s->io->ctx, LOGDL_INFO, 0, s->size, NULL, 0);
+        break;
+    }
+
+    case LOGDL_ACK:
+        if (s->active && h->offset > s->base && h->offset <= s->next) {
+            s->base = h->offset;
+            s->last_progress_ms = now_ms;
+        }
+        break;
+
+    case LOGDL_NAK:
+        /* Go-back-N: everything from the first missing byte is resent. */
+        if (s->active && h->offset >= s->base && h->offset <= s->next) {
+            s->base = s->next = h->offset;
+            s->last_progress_ms = now_ms;
+        }
+        break;
+
+    case LOGDL_QUIT:
+        logdl_session_close(s);
+        return false;
+
+    default:
+        break;
+    }
+
+    return true;
+}
+
+bool logdl_session_tick(logdl_session_t *s, uint32_t now_ms)
+{
+    /* Lost ACKs or a lost tail chunk: rewind to the oldest unacked byte. */
+    if (s->active && now_ms - s->last_progress_ms > s->ack_timeout_ms) {
+        if (s->next != s->base) s->rewinds++;
+        s->next = s->base;
+        s->done_sent = false;
+        s->last_progress_ms = now_ms;
+    }
+
+    if (now_ms - s->last_rx_ms > s->idle_timeout_ms) {
+        logdl_session_close(s);
+        return false;
+    }
+    return true;
+}
@@ -9,56 +9,225 @@
 #include "app_events.h"
 
 #include "sd_logger.h"
+#include "event_log.h"
+#include "metrics.h"
+#include "summary_stats.h"
 #include "esp_timer.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+
+static const char *TAG = "logger_task";
 
 static inline uint32_t now_ms(void)
 {
     return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
+/* Buffers one line, flushing once to make room if allowed. */
+static bool append_line(const char *line, bool can_flush)
+{
+    if (sd_logger_write_text(line)) return true;
+    return can_flush && sd_logger_flush(sd_mutex) && sd_logger_write_text(line);
+}
+
+/*
+ * Moves pending events into the write buffer: behind the samples already
+ * there, ahead of everything still in sensor_queue. Returns how many were
+ * taken; *oldest_ms is set to the earliest of them.
+ *
+ * An event only leaves event_queue once it is in the buffer. If there is no
+ * room it stays queued for the next call, so a long card outage backs up into
+ * events.dropped at the producer rather than discarding what is already
+ * queued. Only a line that can never be formatted counts as lost.
+ */
+static uint32_t take_events(bool can_flush, uint32_t *oldest_ms, metric_t *m_lost)
+{
+    flight_event_t e;
+    uint32_t n = 0;
+
+    while (xQueuePeek(event_queue, &e, 0) == pdTRUE) {
+        char line[96];
+        int len = event_log_format(&e, line, sizeof(line));
+
+        if (len <= 0 || (size_t)len >= sizeof(line)) {
+            (void)xQueueReceive(event_queue, &e, 0);
+            metrics_inc(m_lost);
+            continue;
+        }
+        if (!append_line(line, can_flush)) break;
+
+        (void)xQueueReceive(event_queue, &e, 0);
+        if (n == 0 || (int32_t)(e.t_ms - *oldest_ms) < 0) *oldest_ms = e.t_ms;
+        n++;
+    }
+
+    return n;
+}
+
+static void sd_lost(void)
+{
+    xEventGroupClearBits(system_events, EVT_SD_OK | EVT_LOGGING_ACTIVE);
+    sd_logger_close(sd_mutex);
+    (void)event_log_post(FLIGHT_EVT_SD_LOST, 0);
+}
+
+/*
+ * Every sample that reaches the logger is folded into the window stats,
+ * whether or not the card is up; a finished window goes to the summary file.
+ */
+static void fold_summary(const sensor_sample_t *s, metric_t *m_dropped)
+{
+    summary_record_t rec;
+
+    if (summary_stats_add(s, &rec)) {
+        if (!sd_logger_write_summary(sd_mutex, &rec)) metrics_inc(m_dropped);
+    }
+}
+
+/*
+ * One line per boot, written straight to the file so it sits ahead of the
+ * samples buffered while the card was coming up. Only called once the logger
+ * has seen a sample: sensor_task sets boot.first_sample_ms before queueing it,
+ * whereas a mount that beats a slow sensor init would otherwise record 0.
+ */
+static void write_boot_record(void)
+{
+    uint32_t first_sample_ms   = metrics_get(metrics_gauge("boot.first_sample_ms"));
+    uint32_t first_sd_write_ms = metrics_get(metrics_gauge("boot.first_sd_write_ms"));
+
+    char line[160];
+    int n = snprintf(
+        line, sizeof(line),
+        "# boot first_sample_ms=%lu first_sample_budget_ms=%u first_sd_write_ms=%lu first_sd_write_budget_ms=%u\n",
+        (unsigned long)first_sample_ms, (unsigned)BOOT_FIRST_SAMPLE_BUDGET_MS,
+        (unsigned long)first_sd_write_ms, (unsigned)BOOT_FIRST_SD_WRITE_BUDGET_MS
+    );
+    if (n > 0 && (size_t)n < sizeof(line)) {
+        (void)sd_logger_write_header(sd_mutex, line);
+    }
+
+    if (first_sample_ms > BOOT_FIRST_SAMPLE_BUDGET_MS || first_sd_write_ms > BOOT_FIRST_SD_WRITE_BUDGET_MS) {
+        ESP_LOGW(TAG, "boot over budget: first_sample=%lums first_sd_write=%lums",
+                 (unsigned long)first_sample_ms, (unsigned long)first_sd_write_ms);
+    }
+}
+
 void logger_task(void *arg)
 {
     uint32_t last_flush_ms = now_ms();
     uint32_t last_sd_retry_ms = 0;
+    bool first_mount_attempt = true;
+    bool first_mount = true;
+    bool boot_record_written = false;
+    bool sample_seen = false;
+    uint32_t mounts = 0;
+
+    /* Events buffered but not yet synced, and the time of the oldest one. */
+    bool events_pending = false;
+    uint32_t events_oldest_ms = 0;
 
     sensor_sample_t sample;
 
+    metric_t *m_written           = metrics_counter("logger.samples");
+    metric_t *m_discarded         = metrics_counter("logger.discarded");
+    metric_t *m_summary_dropped   = metrics_counter("logger.summary_dropped");
+    metric_t *m_overwrites        = metrics_counter("queue.overwrites");
+    metric_t *m_last_overwrite_ms = metrics_gauge("queue.last_overwrite_ms");
+    metric_t *m_event_latency_ms  = metrics_histogram("events.latency_ms");
+    metric_t *m_events_lost       = metrics_counter("events.lost");
+    metric_t *m_first_sd_write_ms = metrics_gauge("boot.first_sd_write_ms");
+
     while (1)
     {
         if (!sd_logger_is_ready())
         {
             uint32_t t = now_ms();
-            if (t - last_sd_retry_ms > 2000) {
+            if (first_mount_attempt || t - last_sd_retry_ms > SD_RETRY_INTERVAL_MS) {
                 if (sd_logger_init(sd_mutex)) {
                     xEventGroupSetBits(system_events, EVT_SD_OK | EVT_LOGGING_ACTIVE);
-                } else {
-                    xEventGroupClearBits(system_events, EVT_SD_OK | EVT_LOGGING_ACTIVE);
+                    if (first_mount) {
+                        metrics_set(m_first_sd_write_ms, now_ms());
+                        first_mount = false;
+                    }
+                    (void)event_log_post(FLIGHT_EVT_SD_MOUNTED, (int32_t)++mounts);
+
+                    /* Backlog from the outage: the latency budget starts now. */
+                    if (events_pending) events_oldest_ms = now_ms();
+                    continue;
                 }
-                last_sd_retry_ms = t;
+
+                xEventGroupClearBits(system_events, EVT_SD_OK | EVT_LOGGING_ACTIVE);
+                first_mount_attempt = false;
+                last_sd_retry_ms = now_ms();
             }
 
-            /* Keep draining the queue so overwrite stats remain meaningful. */
+            /*
+             * No card: keep sampling into the RAM write buffer so the start of
+             * the flight survives a slow mount. Only once that is full are
+             * samples dropped (the queue keeps draining so overwrite stats stay
+             * meaningful). Events are buffered the same way; once the buffer
+             * is full they wait in event_queue until the card is back.
+             */
+            if (take_events(false, &events_oldest_ms, m_events_lost)) events_pending = true;
+
             if (xQueueReceive(sensor_queue, &sample, pdMS_TO_TICKS(50)) == pdTRUE) {
-                /* discard */
+                sample_seen = true;
+                fold_summary(&sample, m_summary_dropped);
+                if (sd_logger_write_sample(&sample)) metrics_inc(m_written);
+                else                                 metrics_inc(m_discarded);
             }
 
             continue;
         }
 
-        if (xQueueReceive(sensor_queue, &sample, portMAX_DELAY) == pdTRUE)
+        if (!boot_record_written && sample_seen) {
+            write_boot_record();
+            boot_record_written = true;
+        }
+
+        /*
+         * Events jump the sample queue and are synced right away. The receive
+         * below is bounded by EVENT_POLL_MS so a post is picked up promptly
+         * even when samples stop arriving.
+         */
+        if (take_events(true, &events_oldest_ms, m_events_lost)) events_pending = true;
+
+        if (events_pending) {
+            if (!sd_logger_sync(sd_mutex)) {
+                events_pending = false;
+                sd_lost();
+                continue;
+            }
+
+            uint32_t latency_ms = now_ms() - events_oldest_ms;
+            metrics_observe(m_event_latency_ms, latency_ms);
+            if (latency_ms > EVENT_FLUSH_MAX_LATENCY_MS) {
+                ESP_LOGW(TAG, "event sync took %lums", (unsigned long)latency_ms);
+            }
+
+            events_pending = false;
+            last_flush_ms = now_ms();
+        }
+
+        if (xQueueReceive(sensor_queue, &sample, pdMS_TO_TICKS(EVENT_POLL_MS)) == pdTRUE)
         {
+            sample_seen = true;
+            fold_summary(&sample, m_summary_dropped);
+
             /*
              * If the buffer is full, flush and retry once. If that fails, I mark SD
              * down and let the retry logic remount later.
              */
             if (!sd_logger_write_sample(&sample)) {
                 if (!sd_logger_flush(sd_mutex) || !sd_logger_write_sample(&sample)) {
-                    xEventGroupClearBits(system_events, EVT_SD_OK | EVT_LOGGING_ACTIVE);
-                    sd_logger_close(sd_mutex);
+                    sd_lost();
                     continue;
                 }
             }
 
+            metrics_inc(m_written);
+
             uint32_t t = now_ms();
             if (t - last_flush_ms > SD_FLUSH_INTERVAL_MS)
             {
@@ -67,25 +236,22 @@ void logger_task(void *arg)
                  * This avoids a separate telemetry channel for a metric I mainly
                  * care about post-flight.
                  */
-                if (queue_stats.overwrite_count != 0) {
+                uint32_t overwrites = metrics_get(m_overwrites);
+                if (overwrites != 0) {
                     char diag[96];
                     int n = snprintf(
                         diag, sizeof(diag),
                         "# overwrites=%lu last_overwrite_ms=%lu\n",
-                        (unsigned long)queue_stats.overwrite_count,
-                        (unsigned long)queue_stats.last_overwrite_time_ms
+                        (unsigned long)overwrites,
+                        (unsigned long)metrics_get(m_last_overwrite_ms)
                     );
                     if (n > 0 && (size_t)n < sizeof(diag)) {
-                        if (!sd_logger_write_text(diag)) {
-                            (void)sd_logger_flush(sd_mutex);
-                            (void)sd_logger_write_text(diag);
-                        }
+                        (void)append_line(diag, true);
                     }
                 }
 
                 if (!sd_logger_flush(sd_mutex)) {
-                    xEventGroupClearBits(system_events, EVT_SD_OK | EVT_LOGGING_ACTIVE);
-                    sd_logger_close(sd_mutex);
+                    sd_lost();
                     continue;
                 }
 
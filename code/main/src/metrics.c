@@ -0,0 +1,119 @@
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+static metric_t s_metrics[METRICS_MAX];
+static uint32_t s_count = 0;
+static metric_t s_scratch = { .name = "overflow" };
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static metric_t *metric_get_or_create(const char *name, metric_type_t type)
+{
+    metric_t *m = NULL;
+
+    portENTER_CRITICAL(&s_lock);
+    for (uint32_t i = 0; i < s_count; i++) {
+        if (strcmp(s_metrics[i].name, name) == 0) {
+            m = &s_metrics[i];
+            break;
+        }
+    }
+    if (!m && s_count < METRICS_MAX) {
+        m = &s_metrics[s_count];
+        m->name = name;
+        m->type = type;
+        s_count++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    return m ? m : &s_scratch;
+}
+
+metric_t *metrics_counter(const char *name)
+{
+    return metric_get_or_create(name, METRIC_COUNTER);
+}
+
+metric_t *metrics_gauge(const char *name)
+{
+    return metric_get_or_create(name, METRIC_GAUGE);
+}
+
+metric_t *metrics_histogram(const char *name)
+{
+    return metric_get_or_create(name, METRIC_HISTOGRAM);
+}
+
+/* Bucket holding the q-th percentile (q in 1..100). */
+static uint32_t hist_percentile(const uint32_t *b, uint32_t total, uint32_t q)
+{
+    uint32_t target = (total * q + 99) / 100;
+    uint32_t seen = 0;
+
+    for (uint32_t i = 0; i < METRIC_HIST_BUCKETS; i++) {
+        seen += b[i];
+        if (seen >= target) return i;
+    }
+    return METRIC_HIST_BUCKETS - 1;
+}
+
+/*
+ * "<2^i" for a normal bucket. The overflow bucket has no upper bound, so it
+ * prints as ">=" its lower one instead of a limit the values may exceed.
+ */
+static const char *hist_bound(uint32_t bucket, char *buf, size_t len)
+{
+    if (bucket == METRIC_HIST_BUCKETS - 1) {
+        snprintf(buf, len, ">=%lu", (unsigned long)(1UL << (bucket - 1)));
+    } else {
+        snprintf(buf, len, "<%lu", (unsigned long)(1UL << bucket));
+    }
+    return buf;
+}
+
+void metrics_dump(void)
+{
+    uint32_t n = __atomic_load_n(&s_count, __ATOMIC_RELAXED);
+
+    for (uint32_t i = 0; i < n; i++) {
+        const metric_t *m = &s_metrics[i];
+
+        switch (m->type) {
+        case METRIC_COUNTER:
+            printf("counter %-24s %lu\n", m->name, (unsigned long)metrics_get(m));
+            break;
+
+        case METRIC_GAUGE:
+            printf("gauge   %-24s %lu\n", m->name, (unsigned long)metrics_get(m));
+            break;
+
+        case METRIC_HISTOGRAM: {
+            /* Snapshot first so the percentiles agree with the count. */
+            uint32_t b[METRIC_HIST_BUCKETS];
+            uint32_t total = 0;
+            for (uint32_t k = 0; k < METRIC_HIST_BUCKETS; k++) {
+                b[k] = __atomic_load_n(&m->buckets[k], __ATOMIC_RELAXED);
+                total += b[k];
+            }
+
+            if (total == 0) {
+                printf("hist    %-24s n=0\n", m->name);
+                break;
+            }
+
+            char p50[16], p99[16];
+            printf("hist    %-24s n=%lu p50%s p99%s max=%lu\n",
+                   m->name,
+                   (unsigned long)total,
+                   hist_bound(hist_percentile(b, total, 50), p50, sizeof(p50)),
+                   hist_bound(hist_percentile(b, total, 99), p99, sizeof(p99)),
+                   (unsigned long)metrics_get(m));
+            break;
+        }
+        }
+    }
+}
@@ -2,10 +2,14 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "app_config.h"
+#include "app_mem.h"
+#include "metrics.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 
 #include "driver/spi_master.h"
 #include "sdmmc_cmd.h"
@@ -16,11 +20,21 @@ static const char *TAG = "sd_logger";
 
 static sdmmc_card_t *s_card = NULL;
 static FILE *s_fp = NULL;
+static FILE *s_sum_fp = NULL;
 
-static char s_buf[SD_BUFFER_SIZE_BYTES];
+/*
+ * Write buffer comes from app_mem (arena or heap) on the first init and is
+ * kept across remounts, so its size is set purely by SD_BUFFER_SIZE_BYTES.
+ */
+static char *s_buf = NULL;
 static size_t s_buf_len = 0;
 static bool s_ready = false;
 
+static metric_t *m_bytes_written;
+static metric_t *m_flush_us;
+static metric_t *m_mounts;
+static metric_t *m_write_errors;
+
 bool sd_logger_is_ready(void)
 {
     return s_ready;
@@ -33,8 +47,8 @@ static void buffer_reset(void)
 
 static bool buffer_append(const char *line, size_t n)
 {
-    if (n > sizeof(s_buf)) return false;
-    if (s_buf_len + n > sizeof(s_buf)) return false;
+    if (n > SD_BUFFER_SIZE_BYTES) return false;
+    if (s_buf_len + n > SD_BUFFER_SIZE_BYTES) return false;
 
     memcpy(&s_buf[s_buf_len], line, n);
     s_buf_len += n;
@@ -50,6 +64,22 @@ bool sd_logger_init(SemaphoreHandle_t sd_mutex)
         return true;
     }
 
+    if (!m_bytes_written) {
+        m_bytes_written = metrics_counter("sd.bytes_written");
+        m_flush_us      = metrics_histogram("sd.flush_us");
+        m_mounts        = metrics_counter("sd.mounts");
+        m_write_errors  = metrics_counter("sd.write_errors");
+    }
+
+    if (!s_buf) {
+        s_buf = app_mem_alloc(SD_BUFFER_SIZE_BYTES);
+        if (!s_buf) {
+            ESP_LOGE(TAG, "no memory for write buffer");
+            xSemaphoreGive(sd_mutex);
+            return false;
+        }
+    }
+
     sdmmc_host_t host = SDSPI_HOST_DEFAULT();
     host.slot = SD_SPI_HOST;
 
@@ -102,8 +132,18 @@ bool sd_logger_init(SemaphoreHandle_t sd_mutex)
         fflush(s_fp);
     }
 
-    buffer_reset();
+    /* Summary stream is optional; the raw log carries on without it. */
+    s_sum_fp = fopen(SD_SUMMARY_FILENAME, "ab");
+    if (!s_sum_fp) {
+        ESP_LOGW(TAG, "failed to open summary file: %s", SD_SUMMARY_FILENAME);
+    }
+
+    /*
+     * The buffer is deliberately not reset: anything captured while the card
+     * was absent goes out with the first flush.
+     */
     s_ready = true;
+    metrics_inc(m_mounts);
 
     xSemaphoreGive(sd_mutex);
     return true;
@@ -111,7 +151,8 @@ bool sd_logger_init(SemaphoreHandle_t sd_mutex)
 
 bool sd_logger_write_sample(const sensor_sample_t *s)
 {
-    if (!s_ready || !s_fp || !s) return false;
+    /* Only needs the RAM buffer, so sampling can start before the card mounts. */
+    if (!s_buf || !s) return false;
 
     char line[160];
 
@@ -137,36 +178,120 @@ bool sd_logger_write_sample(const sensor_sample_t *s)
 
 bool sd_logger_write_text(const char *text)
 {
-    if (!s_ready || !s_fp || !text) return false;
+    if (!s_buf || !text) return false;
     return buffer_append(text, strlen(text));
 }
 
-bool sd_logger_flush(SemaphoreHandle_t sd_mutex)
+bool sd_logger_write_header(SemaphoreHandle_t sd_mutex, const char *text)
 {
     xSemaphoreTake(sd_mutex, portMAX_DELAY);
 
-    if (!s_ready || !s_fp) {
+    if (!s_ready || !s_fp || !text) {
         xSemaphoreGive(sd_mutex);
         return false;
     }
 
-    if (s_buf_len == 0) {
+    bool ok = fputs(text, s_fp) >= 0 && fflush(s_fp) == 0;
+
+    xSemaphoreGive(sd_mutex);
+    return ok;
+}
+
+bool sd_logger_write_summary(SemaphoreHandle_t sd_mutex, const summary_record_t *r)
+{
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+
+    if (!s_ready || !s_sum_fp || !r) {
         xSemaphoreGive(sd_mutex);
-        return true;
+        return false;
     }
 
+    bool ok = fwrite(r, sizeof(*r), 1, s_sum_fp) == 1;
+
+    xSemaphoreGive(sd_mutex);
+    return ok;
+}
+
+/* Caller holds sd_mutex. */
+static bool flush_locked(void)
+{
+    if (s_buf_len == 0) return true;
+
+    int64_t t0_us = esp_timer_get_time();
+
     size_t written = fwrite(s_buf, 1, s_buf_len, s_fp);
     if (written != s_buf_len) {
         ESP_LOGE(TAG, "short write: %u/%u", (unsigned)written, (unsigned)s_buf_len);
-        xSemaphoreGive(sd_mutex);
+        metrics_inc(m_write_errors);
         return false;
     }
 
     fflush(s_fp);
+    if (s_sum_fp) fflush(s_sum_fp);
+    metrics_observe(m_flush_us, (uint32_t)(esp_timer_get_time() - t0_us));
+    metrics_add(m_bytes_written, (uint32_t)written);
     buffer_reset();
+    return true;
+}
+
+bool sd_logger_flush(SemaphoreHandle_t sd_mutex)
+{
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+
+    if (!s_ready || !s_fp) {
+        xSemaphoreGive(sd_mutex);
+        return false;
+    }
+
+    bool ok = flush_locked();
 
     xSemaphoreGive(sd_mutex);
-    return true;
+    return ok;
+}
+
+/*
+ * Caller holds sd_mutex. fflush only hands data to FATFS; fsync also writes
+ * the cluster chain and directory entry, which is what makes the bytes
+ * survive power loss.
+ */
+static bool fsync_locked(void)
+{
+    bool ok = fflush(s_fp) == 0 && fsync(fileno(s_fp)) == 0;
+    if (!ok) metrics_inc(m_write_errors);
+
+    /* Best effort: the summary stream is optional and has its own error path. */
+    if (ok && s_sum_fp) (void)fsync(fileno(s_sum_fp));
+    return ok;
+}
+
+bool sd_logger_sync(SemaphoreHandle_t sd_mutex)
+{
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+
+    if (!s_ready || !s_fp) {
+        xSemaphoreGive(sd_mutex);
+        return false;
+    }
+
+    bool ok = flush_locked() && fsync_locked();
+
+    xSemaphoreGive(sd_mutex);
+    return ok;
+}
+
+bool sd_logger_sync_file(SemaphoreHandle_t sd_mutex)
+{
+    xSemaphoreTake(sd_mutex, portMAX_DELAY);
+
+    if (!s_ready || !s_fp) {
+        xSemaphoreGive(sd_mutex);
+        return false;
+    }
+
+    bool ok = fsync_locked();
+
+    xSemaphoreGive(sd_mutex);
+    return ok;
 }
 
 void sd_logger_close(SemaphoreHandle_t sd_mutex)
@@ -182,6 +307,11 @@ void sd_logger_close(SemaphoreHandle_t sd_mutex)
         s_fp = NULL;
     }
 
+    if (s_sum_fp) {
+        fclose(s_sum_fp);
+        s_sum_fp = NULL;
+    }
+
     if (s_card) {
         esp_vfs_fat_sdcard_unmount(SD_MOUNT_POINT, s_card);
         s_card = NULL;
@@ -0,0 +1,102 @@
+#include "sensor_driver.h"
+
+#include "app_config.h"
+#include "i2c_bus.h"
+#include "esp_log.h"
+
+static const char *TAG = "sensor_driver";
+
+bool sensor_driver_check_id(const sensor_driver_t *dev, TickType_t deadline)
+{
+    uint8_t id = 0;
+    if (!i2c_bus_read_reg(dev->addr7, dev->id_reg, &id, 1, deadline)) return false;
+
+    if (id != dev->id_val) {
+        ESP_LOGW(TAG, "%s: id 0x%02x, expected 0x%02x", dev->name, id, dev->id_val);
+        return false;
+    }
+    return true;
+}
+
+/* Reads back the span a block wrote in one burst and compares. */
+static bool verify_block(const sensor_driver_t *dev, const sensor_reg_block_t *blk, TickType_t deadline)
+{
+    uint8_t lo = 0xFF, hi = 0;
+    for (uint8_t i = 0; i < blk->count; i++) {
+        if (blk->writes[i].reg < lo) lo = blk->writes[i].reg;
+        if (blk->writes[i].reg > hi) hi = blk->writes[i].reg;
+    }
+
+    size_t span = (size_t)(hi - lo) + 1;
+    if (span > SENSOR_MAX_BURST) return false;
+
+    uint8_t rb[SENSOR_MAX_BURST];
+    if (!i2c_bus_read_reg(dev->addr7, lo, rb, span, deadline)) return false;
+
+    for (uint8_t i = 0; i < blk->count; i++) {
+        const sensor_reg_write_t *w = &blk->writes[i];
+        if (rb[w->reg - lo] != w->val) {
+            ESP_LOGW(TAG, "%s: reg 0x%02x reads 0x%02x, wrote 0x%02x", dev->name, w->reg, rb[w->reg - lo], w->val);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool write_block(const sensor_driver_t *dev, const sensor_reg_block_t *blk, TickType_t deadline)
+{
+    uint8_t pkt[2 * SENSOR_MAX_BURST];
+    size_t n = 0;
+
+    if (blk->count == 0 || blk->count > SENSOR_MAX_BURST) return false;
+
+    if (dev->burst == SENSOR_BURST_PAIRS) {
+        for (uint8_t i = 0; i < blk->count; i++) {
+            pkt[n++] = blk->writes[i].reg;
+            pkt[n++] = blk->writes[i].val;
+        }
+    } else {
+        pkt[n++] = blk->writes[0].reg;
+        for (uint8_t i = 0; i < blk->count; i++) {
+            if (blk->writes[i].reg != (uint8_t)(blk->writes[0].reg + i)) {
+                ESP_LOGE(TAG, "%s: block at 0x%02x is not contiguous", dev->name, blk->writes[0].reg);
+                return false;
+            }
+            pkt[n++] = blk->writes[i].val;
+        }
+    }
+
+    if (!i2c_bus_write(dev->addr7, pkt, n, deadline)) return false;
+
+    return !blk->verify || verify_block(dev, blk, deadline);
+}
+
+bool sensor_driver_write_seq(const sensor_driver_t *dev, const sensor_seq_t *seq, TickType_t deadline)
+{
+    for (uint8_t i = 0; i < seq->count; i++) {
+        if (!write_block(dev, &seq->blocks[i], deadline)) return false;
+    }
+    return true;
+}
+
+bool sensor_driver_init(const sensor_driver_t *dev, SemaphoreHandle_t i2c_mutex)
+{
+    TickType_t deadline = i2c_bus_deadline_in(I2C_INIT_TIMEOUT_MS);
+    if (!i2c_bus_lock(i2c_mutex, deadline)) return false;
+
+    bool ok = sensor_driver_check_id(dev, deadline) &&
+              sensor_driver_write_seq(dev, &dev->init, deadline);
+
+    i2c_bus_unlock(i2c_mutex);
+    return ok;
+}
+
+bool sensor_driver_read_frame(const sensor_driver_t *dev, uint8_t *raw, SemaphoreHandle_t i2c_mutex, TickType_t deadline)
+{
+    if (!i2c_bus_lock(i2c_mutex, deadline)) return false;
+
+    bool ok = i2c_bus_read_reg(dev->addr7, dev->frame_reg, raw, dev->frame_len, deadline);
+
+    i2c_bus_unlock(i2c_mutex);
+    return ok;
+}
@@ -8,42 +8,177 @@
 #include "app_config.h"
 #include "app_events.h"
 
+#include "i2c_bus.h"
 #include "imu_driver.h"
 #include "baro_driver.h"
+#include "event_log.h"
+#include "metrics.h"
+#include "sensor_units.h"
 
 #include "esp_timer.h"
 #include "esp_compiler.h"
+#include "esp_log.h"
 
-static inline uint32_t now_ms(void)
+static const char *TAG = "sensor_task";
+
+typedef struct
 {
-    return (uint32_t)(esp_timer_get_time() / 1000);
+    const char *name;
+    flight_sensor_t id;
+    EventBits_t ok_bit;
+    bool (*init)(SemaphoreHandle_t i2c_mutex);
+
+    /*
+     * `healthy` is cleared only by sensor_task and set only by the recovery
+     * task, so a plain volatile flag is enough to hand ownership across.
+     */
+    volatile bool healthy;
+    uint32_t consecutive_fails;
+    metric_t *misses;
+} sensor_health_t;
+
+static sensor_health_t s_imu  = { .name = "imu",  .id = FLIGHT_SENSOR_IMU,  .ok_bit = EVT_IMU_OK,  .init = imu_init };
+static sensor_health_t s_baro = { .name = "baro", .id = FLIGHT_SENSOR_BARO, .ok_bit = EVT_BARO_OK, .init = baro_init };
+
+static metric_t *m_samples;
+static metric_t *m_read_us;
+static metric_t *m_overwrites;
+static metric_t *m_last_overwrite_ms;
+static metric_t *m_recoveries;
+
+static void health_set(sensor_health_t *h, bool healthy)
+{
+    h->consecutive_fails = 0;
+    h->healthy = healthy;
+
+    if (healthy) xEventGroupSetBits(system_events, h->ok_bit);
+    else         xEventGroupClearBits(system_events, h->ok_bit);
+
+    (void)event_log_post(healthy ? FLIGHT_EVT_SENSOR_UP : FLIGHT_EVT_SENSOR_DOWN, h->id);
+}
+
+/*
+ * A clipped axis reads at most full scale, so a threshold at or above it
+ * could never be crossed under boost, which is exactly when it matters.
+ */
+_Static_assert(LAUNCH_ACCEL_THRESHOLD_MG < IMU_ACCEL_FULL_SCALE_G * 1000,
+               "LAUNCH_ACCEL_THRESHOLD_MG must be below the accelerometer full scale");
+
+/*
+ * Latches once |a| has stayed above LAUNCH_ACCEL_THRESHOLD_MG for
+ * LAUNCH_DETECT_MS. Squared raw counts, so no sqrt or float on this path.
+ * With an axis on the rail the reported peak is a lower bound.
+ */
+static void launch_check(const sensor_sample_t *s)
+{
+    static const int64_t threshold_sq =
+        (int64_t)(LAUNCH_ACCEL_THRESHOLD_MG * IMU_ACCEL_LSB_PER_G / 1000.0f) *
+        (int64_t)(LAUNCH_ACCEL_THRESHOLD_MG * IMU_ACCEL_LSB_PER_G / 1000.0f);
+
+    static bool launched = false;
+    static bool above = false;
+    static uint32_t above_since_ms = 0;
+    static int64_t peak_sq = 0;
+
+    if (launched || !s->imu_ok) return;
+
+    int64_t a_sq = (int64_t)s->ax * s->ax + (int64_t)s->ay * s->ay + (int64_t)s->az * s->az;
+    if (a_sq <= threshold_sq) {
+        above = false;
+        peak_sq = 0;
+        return;
+    }
+
+    if (!above) {
+        above = true;
+        above_since_ms = s->t_ms;
+    }
+    if (a_sq > peak_sq) peak_sq = a_sq;
+
+    if (s->t_ms - above_since_ms >= LAUNCH_DETECT_MS) {
+        launched = true;
+        float peak_g = sqrtf((float)peak_sq) / IMU_ACCEL_LSB_PER_G;
+        (void)event_log_post(FLIGHT_EVT_LAUNCH, (int32_t)(peak_g * 1000.0f));
+        ESP_LOGI(TAG, "launch detected at %lums", (unsigned long)s->t_ms);
+    }
+}
+
+static void health_update(sensor_health_t *h, bool read_ok)
+{
+    if (likely(read_ok)) {
+        h->consecutive_fails = 0;
+        return;
+    }
+
+    metrics_inc(h->misses);
+
+    /*
+     * One miss is one missing sample. Only a run of misses takes the sensor
+     * out of the loop and hands it to the recovery task.
+     */
+    if (++h->consecutive_fails >= SENSOR_FAIL_THRESHOLD) {
+        ESP_LOGW(TAG, "%s failed %lu reads in a row, handing to recovery",
+                 h->name, (unsigned long)h->consecutive_fails);
+        health_set(h, false);
+    }
 }
 
 void sensor_task(void *arg)
 {
-    bool imu_ok  = imu_init(i2c_mutex);
-    bool baro_ok = baro_init(i2c_mutex);
+    m_samples           = metrics_counter("sensor.samples");
+    m_read_us           = metrics_histogram("sensor.read_us");
+    m_overwrites        = metrics_counter("queue.overwrites");
+    m_last_overwrite_ms = metrics_gauge("queue.last_overwrite_ms");
+    s_imu.misses        = metrics_counter("sensor.imu_miss");
+    s_baro.misses       = metrics_counter("sensor.baro_miss");
 
-    if (imu_ok)  xEventGroupSetBits(system_events, EVT_IMU_OK);
-    else         xEventGroupClearBits(system_events, EVT_IMU_OK);
+    metric_t *m_first_sample_ms = metrics_gauge("boot.first_sample_ms");
 
-    if (baro_ok) xEventGroupSetBits(system_events, EVT_BARO_OK);
-    else         xEventGroupClearBits(system_events, EVT_BARO_OK);
+    /*
+     * Boot path: kick the BMP280 reset first, bring the IMU up while it
+     * restarts, then finish the baro. SD mount runs in logger_task at the
+     * same time and samples queue up in RAM until the card is ready.
+     */
+    bool baro_reset_ok = baro_reset(i2c_mutex);
+    health_set(&s_imu,  imu_init(i2c_mutex));
+    health_set(&s_baro, baro_reset_ok && baro_configure(i2c_mutex));
 
+    bool first_sample = true;
+    bool overflowing = false;
+    uint32_t last_overwrite_ms = 0;
     TickType_t last_wake = xTaskGetTickCount();
 
+    /* Sample first, then wait, so the first sample is not a period late. */
     while (1)
     {
-        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SENSOR_PERIOD_MS));
+        int64_t t0_us = esp_timer_get_time();
 
         sensor_sample_t sample = {0};
-        sample.t_ms = now_ms();
+        sample.t_ms = (uint32_t)(t0_us / 1000);
+
+        /*
+         * Each sensor gets its own deadline for lock + read, so a hung IMU
+         * cannot eat the barometer's slot (and vice versa).
+         */
+        if (s_imu.healthy) {
+            sample.imu_ok = imu_read(&sample, i2c_mutex, i2c_bus_deadline_in(I2C_READ_BUDGET_MS));
+            health_update(&s_imu, sample.imu_ok);
+        }
 
-        if (imu_ok)  sample.imu_ok  = imu_read(&sample, i2c_mutex);
-        else         sample.imu_ok  = 0;
+        if (s_baro.healthy) {
+            sample.baro_ok = baro_read_pressure(&sample, i2c_mutex, i2c_bus_deadline_in(I2C_READ_BUDGET_MS));
+            health_update(&s_baro, sample.baro_ok);
+        }
 
-        if (baro_ok) sample.baro_ok = baro_read_pressure(&sample, i2c_mutex);
-        else         sample.baro_ok = 0;
+        metrics_observe(m_read_us, (uint32_t)(esp_timer_get_time() - t0_us));
+        metrics_inc(m_samples);
+
+        launch_check(&sample);
+
+        if (unlikely(first_sample)) {
+            metrics_set(m_first_sample_ms, sample.t_ms);
+            first_sample = false;
+        }
 
         /*
          * Sensor task does not block. If the queue is full, I drop the oldest
@@ -56,11 +191,79 @@ void sensor_task(void *arg)
             (void)xQueueReceive(sensor_queue, &discarded, 0);
             (void)xQueueSend(sensor_queue, &sample, 0);
 
-            queue_stats.overwrite_count++;
-            queue_stats.last_overwrite_time_ms = sample.t_ms;
+            metrics_inc(m_overwrites);
+            metrics_set(m_last_overwrite_ms, sample.t_ms);
+            last_overwrite_ms = sample.t_ms;
+
+            /* One event per burst, not per dropped sample. */
+            if (!overflowing) {
+                overflowing = true;
+                (void)event_log_post(FLIGHT_EVT_OVERFLOW_BURST, (int32_t)metrics_get(m_overwrites));
+            }
         }
+        else if (overflowing && sample.t_ms - last_overwrite_ms >= OVERFLOW_BURST_QUIET_MS)
+        {
+            /*
+             * A backed-up logger frees one slot at a time, so a single good
+             * send does not end the burst; every event costs it an fsync, and
+             * re-arming on each one would only deepen the backlog.
+             */
+            overflowing = false;
+        }
+
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SENSOR_PERIOD_MS));
     }
 }
 
-        
-        
+static bool try_reinit(sensor_health_t *h)
+{
+    if (h->healthy) return true;
+
+    if (!h->init(i2c_mutex)) return false;
+
+    ESP_LOGI(TAG, "%s recovered", h->name);
+    health_set(h, true);
+    return true;
+}
+
+void sensor_recovery_task(void *arg)
+{
+    uint32_t backoff = 1;
+
+    m_recoveries = metrics_counter("i2c.recoveries");
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(I2C_RECOVERY_RETRY_MS * backoff));
+
+        if (s_imu.healthy && s_baro.healthy) {
+            backoff = 1;
+            continue;
+        }
+
+        xEventGroupSetBits(system_events, EVT_I2C_RECOVERY);
+
+        /*
+         * Try a plain re-init first; only if that fails is the bus itself
+         * suspect, and then it is cleared and reinstalled before retrying.
+         */
+        bool imu_ok  = try_reinit(&s_imu);
+        bool baro_ok = try_reinit(&s_baro);
+
+        if (!imu_ok || !baro_ok) {
+            metrics_inc(m_recoveries);
+            (void)i2c_bus_recover(i2c_mutex);
+            imu_ok  = try_reinit(&s_imu);
+            baro_ok = try_reinit(&s_baro);
+        }
+
+        /*
+         * A sensor that is simply not fitted would otherwise cost a bus reset
+         * (and a missed sample) every retry; back off up to 8x.
+         */
+        if (imu_ok && baro_ok)  backoff = 1;
+        else if (backoff < 8)   backoff *= 2;
+
+        xEventGroupClearBits(system_events, EVT_I2C_RECOVERY);
+    }
+}
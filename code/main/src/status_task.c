@@ -6,9 +6,27 @@
 
 #include "app_init.h"
 #include "app_events.h"
+#include "app_config.h"
+#include "app_mem.h"
+#include "console.h"
+#include "metrics.h"
 
 void status_task(void *arg)
 {
+    TickType_t last_mem_report = xTaskGetTickCount();
+    TickType_t last_rate = last_mem_report;
+
+    /*
+     * Gauges that need a sampling interval (queue depth, SD throughput) are
+     * computed here rather than in the tasks that own the data.
+     */
+    metric_t *m_queue_depth   = metrics_gauge("queue.depth");
+    metric_t *m_sd_bytes      = metrics_counter("sd.bytes_written");
+    metric_t *m_sd_rate       = metrics_gauge("sd.bytes_per_s");
+    uint32_t last_sd_bytes    = metrics_get(m_sd_bytes);
+
+    console_init();
+
     while (1)
     {
         EventBits_t e = xEventGroupGetBits(system_events);
@@ -24,9 +42,27 @@ void status_task(void *arg)
         /*
          * TODO:
          * - Map these states to LED patterns once I pick GPIO + UX.
-         * - Optionally add a debug UART line here (not in sensor/logger paths).
          */
 
+        console_poll();
+
+        TickType_t now = xTaskGetTickCount();
+        if (now - last_rate >= pdMS_TO_TICKS(STATUS_RATE_INTERVAL_MS)) {
+            uint32_t bytes = metrics_get(m_sd_bytes);
+            uint32_t elapsed_ms = pdTICKS_TO_MS(now - last_rate);
+
+            metrics_set(m_queue_depth, (uint32_t)uxQueueMessagesWaiting(sensor_queue));
+            metrics_set(m_sd_rate, (uint32_t)((uint64_t)(bytes - last_sd_bytes) * 1000 / elapsed_ms));
+
+            last_sd_bytes = bytes;
+            last_rate = now;
+        }
+
+        if (xTaskGetTickCount() - last_mem_report >= pdMS_TO_TICKS(APP_MEM_REPORT_INTERVAL_MS)) {
+            app_mem_report();
+            last_mem_report = xTaskGetTickCount();
+        }
+
         vTaskDelay(pdMS_TO_TICKS(250));
     }
 }
@@ -0,0 +1,100 @@
+#include "summary_stats.h"
+
+#include <string.h>
+
+#include "app_config.h"
+#include "sensor_units.h"
+
+typedef struct
+{
+    uint32_t n;
+    float mean;
+    float m2;
+    int32_t min;
+    int32_t max;
+} welford_t;
+
+static welford_t s_ch[SUMMARY_CHANNELS];
+static uint16_t s_saturated[SUMMARY_IMU_AXES];
+static uint32_t s_t_start_ms = 0;
+static uint32_t s_t_last_ms = 0;
+static bool s_open = false;
+
+static inline void welford_add(welford_t *w, int32_t x)
+{
+    if (w->n == 0) {
+        w->min = x;
+        w->max = x;
+    } else {
+        if (x < w->min) w->min = x;
+        if (x > w->max) w->max = x;
+    }
+
+    w->n++;
+    float d = (float)x - w->mean;
+    w->mean += d / (float)w->n;
+    w->m2 += d * ((float)x - w->mean);
+}
+
+static void window_start(uint32_t t_ms)
+{
+    memset(s_ch, 0, sizeof(s_ch));
+    memset(s_saturated, 0, sizeof(s_saturated));
+
+    /* Windows are aligned to multiples of the period so they line up across files. */
+    s_t_start_ms = t_ms - (t_ms % SUMMARY_WINDOW_MS);
+    s_open = true;
+}
+
+static void window_finish(summary_record_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    out->magic = SUMMARY_MAGIC;
+    out->t_start_ms = s_t_start_ms;
+    out->t_end_ms = s_t_last_ms;
+    out->n_imu = (uint16_t)s_ch[SUM_AX].n;
+    out->n_baro = (uint16_t)s_ch[SUM_PRESSURE].n;
+    memcpy(out->saturated, s_saturated, sizeof(out->saturated));
+
+    for (int i = 0; i < SUMMARY_CHANNELS; i++) {
+        const welford_t *w = &s_ch[i];
+        out->ch[i].min = w->min;
+        out->ch[i].max = w->max;
+        out->ch[i].mean = w->mean;
+        out->ch[i].var = w->n ? w->m2 / (float)w->n : 0.0f;
+    }
+}
+
+static inline bool saturated(int16_t v)
+{
+    return v >= IMU_RAW_SAT_POS || v <= IMU_RAW_SAT_NEG;
+}
+
+bool summary_stats_add(const sensor_sample_t *s, summary_record_t *out)
+{
+    bool closed = false;
+
+    if (s_open && s->t_ms - s_t_start_ms >= SUMMARY_WINDOW_MS) {
+        window_finish(out);
+        closed = true;
+        s_open = false;
+    }
+
+    if (!s_open) window_start(s->t_ms);
+    s_t_last_ms = s->t_ms;
+
+    if (s->imu_ok) {
+        const int16_t axes[SUMMARY_IMU_AXES] = { s->ax, s->ay, s->az, s->gx, s->gy, s->gz };
+        for (int i = 0; i < SUMMARY_IMU_AXES; i++) {
+            welford_add(&s_ch[SUM_AX + i], axes[i]);
+            if (saturated(axes[i])) s_saturated[i]++;
+        }
+    }
+
+    if (s->baro_ok) {
+        welford_add(&s_ch[SUM_PRESSURE], s->pressure_pa);
+    }
+
+    return closed;
+}
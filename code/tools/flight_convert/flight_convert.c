@@ -0,0 +1,922 @@
+/*
+ * Converts flight.csv (as written by sd_logger) to SI units, fast.
+ *
+ *   flight_convert [-j THREADS] [-p P0_PA] [-f col|npy|csv] -o OUT flight.csv
+ *   flight_convert -B SIZE_MB [-j THREADS] SCRATCH_FILE
+ *
+ * The log is memory-mapped and split into one newline-aligned chunk per
+ * thread. A first parallel pass counts lines so every thread can parse
+ * straight into its slice of the shared column arrays; the slices are then
+ * compacted. "# overwrites=" and "# boot" comment lines are collected as
+ * events, the CSV header and malformed lines are skipped.
+ *
+ * The firmware appends to flight.csv, so one file usually holds several
+ * boots. Each restarts its clock; a row whose t_ms is behind the previous
+ * one starts a new boot, as in flight_summary. Rows carry their boot index,
+ * and altitude is relative to that boot's own first pressure reading unless
+ * -p fixes one reference for all of them.
+ *
+ * Output formats:
+ *   col  one file, OUT. Header "FCOL0002", u32 column count, u32 boot count,
+ *        f32 p0_pa per boot, zero-padded to a multiple of 8 bytes, then per
+ *        column: char name[24], u8 dtype (1=u8 2=i32 3=u32 4=f32), u8 pad[7],
+ *        u64 count, u64 byte offset. Column data follows, each block 64-byte
+ *        aligned. Columns may differ in length (events, per-boot values).
+ *   npy  directory OUT with one NumPy .npy per column.
+ *   csv  one file, OUT, converted values.
+ *
+ * -B generates a synthetic log of SIZE_MB, then times a plain sequential
+ * read of it against the full parse so the two can be compared directly.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sensor_units.h"
+
+#define MAX_THREADS     256
+#define COL_ALIGN       64
+
+typedef enum
+{
+    DT_U8  = 1,
+    DT_I32 = 2,
+    DT_U32 = 3,
+    DT_F32 = 4,
+} dtype_t;
+
+typedef struct
+{
+    const char *name;
+    dtype_t dt;
+    void *data;
+    uint64_t count;
+} column_t;
+
+typedef struct
+{
+    uint32_t *t_ms;
+    uint32_t *boot;     // filled after compaction
+    float *ax, *ay, *az;
+    float *gx, *gy, *gz;
+    int32_t *pressure_pa;
+    float *alt_m;
+    uint8_t *imu_ok;
+    uint8_t *baro_ok;
+} table_t;
+
+typedef struct
+{
+    uint32_t *t_ms;
+    uint32_t *count;
+    uint64_t *row;      // data rows before the event: chunk-local, then global
+    uint32_t *boot;     // filled after compaction
+    uint64_t n, cap;
+} events_t;
+
+typedef struct
+{
+    const char *begin;
+    const char *end;
+
+    uint64_t lines;     // pass 1
+    uint64_t row0;      // first row this thread may write
+    uint64_t rows;      // rows actually written
+
+    uint64_t bad_lines;
+    uint64_t boots;
+    events_t overwrites;
+
+    table_t *table;
+} chunk_t;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *xmalloc(size_t n)
+{
+    void *p = malloc(n ? n : 1);
+    if (!p) {
+        fprintf(stderr, "out of memory (%zu bytes)\n", n);
+        exit(1);
+    }
+    return p;
+}
+
+/* ---- hand-written field parsers ------------------------------------- */
+
+#define CSV_FIELDS      10
+
+/*
+ * Parses an optionally signed decimal and returns the character that ended
+ * it, or NULL if there were no digits. There are no bounds checks: every
+ * line handed in ends in '\n', which stops the digit loop.
+ */
+static inline const char *parse_int(const char *p, int64_t *out)
+{
+    bool neg = *p == '-';
+    p += neg;
+
+    unsigned d = (unsigned)(*p - '0');
+    if (d > 9) return NULL;
+
+    int64_t v = 0;
+    do {
+        v = v * 10 + d;
+        d = (unsigned)(*++p - '0');
+    } while (d <= 9);
+
+    *out = neg ? -v : v;
+    return p;
+}
+
+/* One data line; returns the start of the next line, or NULL if malformed. */
+static inline const char *parse_row(const char *p, int64_t v[CSV_FIELDS])
+{
+    for (int i = 0; i < CSV_FIELDS - 1; i++) {
+        p = parse_int(p, &v[i]);
+        if (!p || *p != ',') return NULL;
+        p++;
+    }
+
+    p = parse_int(p, &v[CSV_FIELDS - 1]);
+    if (!p) return NULL;
+    if (*p == '\r') p++;
+    return *p == '\n' ? p + 1 : NULL;
+}
+
+static bool events_push(events_t *e, uint32_t t_ms, uint32_t count, uint64_t row)
+{
+    if (e->n == e->cap) {
+        uint64_t cap = e->cap ? e->cap * 2 : 64;
+        uint32_t *t = realloc(e->t_ms, cap * sizeof(uint32_t));
+        if (t) e->t_ms = t;
+        uint32_t *c = realloc(e->count, cap * sizeof(uint32_t));
+        if (c) e->count = c;
+        uint64_t *r = realloc(e->row, cap * sizeof(uint64_t));
+        if (r) e->row = r;
+        if (!t || !c || !r) return false;
+        e->cap = cap;
+    }
+    e->t_ms[e->n] = t_ms;
+    e->count[e->n] = count;
+    e->row[e->n] = row;
+    e->n++;
+    return true;
+}
+
+static void events_free(events_t *e)
+{
+    free(e->t_ms);
+    free(e->count);
+    free(e->row);
+    free(e->boot);
+}
+
+/* "# overwrites=%lu last_overwrite_ms=%lu" and "# boot ..."; row is chunk-local. */
+static void parse_comment(chunk_t *c, const char *p, const char *eol, uint64_t row)
+{
+    static const char k_ovw[] = "# overwrites=";
+    static const char k_last[] = " last_overwrite_ms=";
+    static const char k_boot[] = "# boot ";
+
+    size_t len = (size_t)(eol - p);
+
+    if (len > sizeof(k_boot) - 1 && memcmp(p, k_boot, sizeof(k_boot) - 1) == 0) {
+        c->boots++;
+        return;
+    }
+
+    if (len <= sizeof(k_ovw) - 1 || memcmp(p, k_ovw, sizeof(k_ovw) - 1) != 0) return;
+    p += sizeof(k_ovw) - 1;
+
+    int64_t count, t_ms;
+    p = parse_int(p, &count);
+    if (!p || (size_t)(eol - p) <= sizeof(k_last) - 1 || memcmp(p, k_last, sizeof(k_last) - 1) != 0) return;
+    p = parse_int(p + sizeof(k_last) - 1, &t_ms);
+    if (!p) return;
+
+    (void)events_push(&c->overwrites, (uint32_t)t_ms, (uint32_t)count, row);
+}
+
+/* ---- altitude --------------------------------------------------------- */
+
+/* Pressure is logged in whole pascals, so powf runs once per value, not per row. */
+#define ALT_LUT_MIN_PA  20000
+#define ALT_LUT_MAX_PA  120000
+
+static float *s_alt_lut;
+static float s_alt_p0;
+
+static void alt_lut_build(float p0)
+{
+    s_alt_p0 = p0;
+    s_alt_lut = xmalloc((ALT_LUT_MAX_PA - ALT_LUT_MIN_PA + 1) * sizeof(float));
+    for (int pa = ALT_LUT_MIN_PA; pa <= ALT_LUT_MAX_PA; pa++) {
+        s_alt_lut[pa - ALT_LUT_MIN_PA] = baro_altitude_m((float)pa, p0);
+    }
+}
+
+static inline float altitude(int64_t pa)
+{
+    if (pa >= ALT_LUT_MIN_PA && pa <= ALT_LUT_MAX_PA) return s_alt_lut[pa - ALT_LUT_MIN_PA];
+    return pa > 0 ? baro_altitude_m((float)pa, s_alt_p0) : NAN;
+}
+
+/* ---- pass 1: count lines -------------------------------------------- */
+
+static void *count_lines(void *arg)
+{
+    chunk_t *c = arg;
+    uint64_t n = 0;
+
+    for (const char *p = c->begin; p < c->end; ) {
+        const char *nl = memchr(p, '\n', (size_t)(c->end - p));
+        n++;
+        if (!nl) break;
+        p = nl + 1;
+    }
+
+    c->lines = n;
+    return NULL;
+}
+
+/* ---- pass 2: parse --------------------------------------------------- */
+
+/* Handles one '\n'-terminated line at p and returns the start of the next. */
+static inline const char *parse_line(chunk_t *c, const char *p, const char *end, uint64_t *row)
+{
+    static const float inv_g = 1.0f / IMU_ACCEL_LSB_PER_G;
+    static const float inv_dps = 1.0f / IMU_GYRO_LSB_PER_DPS;
+
+    if (*p != '#' && *p != 't') {
+        int64_t v[CSV_FIELDS];
+        const char *next = parse_row(p, v);
+        if (next) {
+            table_t *t = c->table;
+            uint64_t r = (*row)++;
+
+            t->t_ms[r] = (uint32_t)v[0];
+            t->ax[r] = (float)v[1] * inv_g;
+            t->ay[r] = (float)v[2] * inv_g;
+            t->az[r] = (float)v[3] * inv_g;
+            t->gx[r] = (float)v[4] * inv_dps;
+            t->gy[r] = (float)v[5] * inv_dps;
+            t->gz[r] = (float)v[6] * inv_dps;
+            t->pressure_pa[r] = (int32_t)v[7];
+            t->imu_ok[r] = (uint8_t)v[8];
+            t->baro_ok[r] = (uint8_t)v[9];
+            return next;
+        }
+    }
+
+    /* Slow path: comments, the CSV header, blank or malformed lines. */
+    const char *eol = memchr(p, '\n', (size_t)(end - p));
+    if (!eol) eol = end;
+
+    if (*p == '#') {
+        parse_comment(c, p, eol, *row - c->row0);
+    } else if (*p != 't' && *p != '\n' && *p != '\r') {
+        c->bad_lines++;
+    }
+    return eol + 1;
+}
+
+static void *parse_chunk(void *arg)
+{
+    chunk_t *c = arg;
+    uint64_t row = c->row0;
+
+    /* Everything before 'safe' is '\n'-terminated; a torn last line is copied out. */
+    const char *safe = c->end;
+    if (c->end > c->begin && c->end[-1] != '\n') {
+        const char *nl = memrchr(c->begin, '\n', (size_t)(c->end - c->begin));
+        safe = nl ? nl + 1 : c->begin;
+    }
+
+    for (const char *p = c->begin; p < safe; ) {
+        p = parse_line(c, p, safe, &row);
+    }
+
+    if (safe < c->end) {
+        char tail[256];
+        size_t n = (size_t)(c->end - safe);
+        if (n < sizeof(tail)) {
+            memcpy(tail, safe, n);
+            tail[n] = '\n';
+            (void)parse_line(c, tail, tail + n + 1, &row);
+        } else {
+            c->bad_lines++;
+        }
+    }
+
+    c->rows = row - c->row0;
+    return NULL;
+}
+
+static void run_threads(chunk_t *chunks, int n, void *(*fn)(void *))
+{
+    pthread_t th[MAX_THREADS];
+
+    for (int i = 0; i < n; i++) {
+        if (pthread_create(&th[i], NULL, fn, &chunks[i]) != 0) {
+            fn(&chunks[i]);
+            th[i] = 0;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (th[i]) pthread_join(th[i], NULL);
+    }
+}
+
+static void table_alloc(table_t *t, uint64_t rows)
+{
+    t->t_ms = xmalloc(rows * sizeof(uint32_t));
+    t->ax = xmalloc(rows * sizeof(float));
+    t->ay = xmalloc(rows * sizeof(float));
+    t->az = xmalloc(rows * sizeof(float));
+    t->gx = xmalloc(rows * sizeof(float));
+    t->gy = xmalloc(rows * sizeof(float));
+    t->gz = xmalloc(rows * sizeof(float));
+    t->pressure_pa = xmalloc(rows * sizeof(int32_t));
+    t->alt_m = xmalloc(rows * sizeof(float));
+    t->imu_ok = xmalloc(rows);
+    t->baro_ok = xmalloc(rows);
+}
+
+static void table_free(table_t *t)
+{
+    free(t->t_ms);
+    free(t->boot);
+    free(t->ax); free(t->ay); free(t->az);
+    free(t->gx); free(t->gy); free(t->gz);
+    free(t->pressure_pa);
+    free(t->alt_m);
+    free(t->imu_ok);
+    free(t->baro_ok);
+}
+
+/* Closes the gaps left by comment / bad lines between thread slices. */
+static uint64_t table_compact(table_t *t, const chunk_t *chunks, int n)
+{
+    uint64_t dst = 0;
+
+    for (int i = 0; i < n; i++) {
+        uint64_t src = chunks[i].row0, k = chunks[i].rows;
+        if (src != dst && k) {
+            memmove(&t->t_ms[dst], &t->t_ms[src], k * sizeof(uint32_t));
+            memmove(&t->ax[dst], &t->ax[src], k * sizeof(float));
+            memmove(&t->ay[dst], &t->ay[src], k * sizeof(float));
+            memmove(&t->az[dst], &t->az[src], k * sizeof(float));
+            memmove(&t->gx[dst], &t->gx[src], k * sizeof(float));
+            memmove(&t->gy[dst], &t->gy[src], k * sizeof(float));
+            memmove(&t->gz[dst], &t->gz[src], k * sizeof(float));
+            memmove(&t->pressure_pa[dst], &t->pressure_pa[src], k * sizeof(int32_t));
+            memmove(&t->alt_m[dst], &t->alt_m[src], k * sizeof(float));
+            memmove(&t->imu_ok[dst], &t->imu_ok[src], k);
+            memmove(&t->baro_ok[dst], &t->baro_ok[src], k);
+        }
+        dst += k;
+    }
+    return dst;
+}
+
+typedef struct
+{
+    table_t table;
+    uint64_t rows;
+    events_t overwrites;
+    uint64_t bad_lines;
+    uint64_t boot_records;  // "# boot" lines, a cross-check on n_boots
+    uint32_t n_boots;
+    float *boot_p0;
+} parsed_t;
+
+/*
+ * Tags every row and event with its boot and fills alt_m against that boot's
+ * p0: the first baro_ok reading, or the -p value when one is given. Runs on
+ * the compacted table, which is a cheap sequential pass next to the parse.
+ */
+static void split_boots(parsed_t *r, float p0_fixed)
+{
+    table_t *t = &r->table;
+    t->boot = xmalloc(r->rows * sizeof(uint32_t));
+
+    uint32_t cap = 8;
+    uint64_t *first_row = xmalloc(cap * sizeof(uint64_t));
+    r->boot_p0 = xmalloc(cap * sizeof(float));
+    r->n_boots = 0;
+
+    for (uint64_t i = 0; i < r->rows; i++) {
+        if (i == 0 || t->t_ms[i] < t->t_ms[i - 1]) {
+            if (r->n_boots == cap) {
+                cap *= 2;
+                uint64_t *f = realloc(first_row, cap * sizeof(uint64_t));
+                float *q = realloc(r->boot_p0, cap * sizeof(float));
+                if (!f || !q) {
+                    fprintf(stderr, "out of memory (%u boots)\n", (unsigned)cap);
+                    exit(1);
+                }
+                first_row = f;
+                r->boot_p0 = q;
+            }
+            first_row[r->n_boots] = i;
+            r->boot_p0[r->n_boots] = p0_fixed;
+            r->n_boots++;
+        }
+
+        uint32_t b = r->n_boots - 1;
+        t->boot[i] = b;
+        if (r->boot_p0[b] <= 0.0f && t->baro_ok[i] && t->pressure_pa[i] > 0) r->boot_p0[b] = (float)t->pressure_pa[i];
+    }
+
+    for (uint32_t b = 0; b < r->n_boots; b++) {
+        if (r->boot_p0[b] <= 0.0f) r->boot_p0[b] = BARO_SEA_LEVEL_PA;
+
+        uint64_t end = b + 1 < r->n_boots ? first_row[b + 1] : r->rows;
+        alt_lut_build(r->boot_p0[b]);
+        for (uint64_t i = first_row[b]; i < end; i++) {
+            t->alt_m[i] = t->baro_ok[i] ? altitude(t->pressure_pa[i]) : NAN;
+        }
+        free(s_alt_lut);
+        s_alt_lut = NULL;
+    }
+
+    /* An event belongs to the boot of the last row logged before it. */
+    events_t *e = &r->overwrites;
+    e->boot = xmalloc(e->n * sizeof(uint32_t));
+    for (uint64_t k = 0; k < e->n; k++) {
+        e->boot[k] = e->row[k] > 0 && e->row[k] <= r->rows ? t->boot[e->row[k] - 1] : 0;
+    }
+
+    free(first_row);
+}
+
+static bool parse_log(const char *data, size_t size, int threads, float p0, parsed_t *out)
+{
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if ((size_t)threads > size / 4096 + 1) threads = (int)(size / 4096 + 1);
+
+    chunk_t *chunks = calloc((size_t)threads, sizeof(chunk_t));
+    if (!chunks) return false;
+
+    /* Newline-aligned split: each chunk ends just after a '\n'. */
+    const char *end = data + size;
+    const char *p = data;
+    for (int i = 0; i < threads; i++) {
+        const char *cut = (i == threads - 1) ? end : data + size / (size_t)threads * (size_t)(i + 1);
+        if (cut < p) cut = p;
+        if (cut < end) {
+            const char *nl = memchr(cut, '\n', (size_t)(end - cut));
+            cut = nl ? nl + 1 : end;
+        }
+        chunks[i].begin = p;
+        chunks[i].end = cut;
+        p = cut;
+    }
+
+    run_threads(chunks, threads, count_lines);
+
+    uint64_t total = 0;
+    for (int i = 0; i < threads; i++) {
+        chunks[i].row0 = total;
+        total += chunks[i].lines;
+    }
+
+    memset(out, 0, sizeof(*out));
+    table_alloc(&out->table, total);
+
+    for (int i = 0; i < threads; i++) {
+        chunks[i].table = &out->table;
+    }
+    run_threads(chunks, threads, parse_chunk);
+
+    out->rows = table_compact(&out->table, chunks, threads);
+
+    /* Events are few; merge them in chunk (= file) order, rows made global. */
+    uint64_t dst = 0;
+    for (int i = 0; i < threads; i++) {
+        const events_t *e = &chunks[i].overwrites;
+        out->bad_lines += chunks[i].bad_lines;
+        out->boot_records += chunks[i].boots;
+        for (uint64_t k = 0; k < e->n; k++) {
+            (void)events_push(&out->overwrites, e->t_ms[k], e->count[k], dst + e->row[k]);
+        }
+        dst += chunks[i].rows;
+        events_free(&chunks[i].overwrites);
+    }
+
+    free(chunks);
+
+    split_boots(out, p0);
+    return true;
+}
+
+/* ---- writers ---------------------------------------------------------- */
+
+static size_t dtype_size(dtype_t dt)
+{
+    switch (dt) {
+    case DT_U8:  return 1;
+    case DT_I32: return 4;
+    case DT_U32: return 4;
+    case DT_F32: return 4;
+    }
+    return 1;
+}
+
+static const char *dtype_npy(dtype_t dt)
+{
+    switch (dt) {
+    case DT_U8:  return "|u1";
+    case DT_I32: return "<i4";
+    case DT_U32: return "<u4";
+    case DT_F32: return "<f4";
+    }
+    return "|u1";
+}
+
+static int build_columns(const parsed_t *r, column_t *cols)
+{
+    const table_t *t = &r->table;
+    int n = 0;
+
+    cols[n++] = (column_t){ "t_ms",          DT_U32, t->t_ms,        r->rows };
+    cols[n++] = (column_t){ "boot",          DT_U32, t->boot,        r->rows };
+    cols[n++] = (column_t){ "ax_g",          DT_F32, t->ax,          r->rows };
+    cols[n++] = (column_t){ "ay_g",          DT_F32, t->ay,          r->rows };
+    cols[n++] = (column_t){ "az_g",          DT_F32, t->az,          r->rows };
+    cols[n++] = (column_t){ "gx_dps",        DT_F32, t->gx,          r->rows };
+    cols[n++] = (column_t){ "gy_dps",        DT_F32, t->gy,          r->rows };
+    cols[n++] = (column_t){ "gz_dps",        DT_F32, t->gz,          r->rows };
+    cols[n++] = (column_t){ "pressure_pa",   DT_I32, t->pressure_pa, r->rows };
+    cols[n++] = (column_t){ "alt_m",         DT_F32, t->alt_m,       r->rows };
+    cols[n++] = (column_t){ "imu_ok",        DT_U8,  t->imu_ok,      r->rows };
+    cols[n++] = (column_t){ "baro_ok",       DT_U8,  t->baro_ok,     r->rows };
+    cols[n++] = (column_t){ "overwrite_t_ms", DT_U32, r->overwrites.t_ms,  r->overwrites.n };
+    cols[n++] = (column_t){ "overwrite_count", DT_U32, r->overwrites.count, r->overwrites.n };
+    cols[n++] = (column_t){ "overwrite_boot", DT_U32, r->overwrites.boot, r->overwrites.n };
+    cols[n++] = (column_t){ "boot_p0_pa",    DT_F32, r->boot_p0,     r->n_boots };
+
+    return n;
+}
+
+static bool write_col(const char *path, const column_t *cols, int n, const parsed_t *r)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+
+    typedef struct __attribute__((packed))
+    {
+        char name[24];
+        uint8_t dtype;
+        uint8_t pad[7];
+        uint64_t count;
+        uint64_t offset;
+    } col_desc_t;
+
+    const char magic[8] = { 'F', 'C', 'O', 'L', '0', '0', '0', '2' };
+    uint32_t hdr[2] = { (uint32_t)n, r->n_boots };
+    size_t p0_bytes = r->n_boots * sizeof(float);
+    size_t p0_pad = (8 - p0_bytes % 8) % 8;
+
+    uint64_t off = sizeof(magic) + sizeof(hdr) + p0_bytes + p0_pad + (uint64_t)n * sizeof(col_desc_t);
+    col_desc_t desc[32];
+
+    for (int i = 0; i < n; i++) {
+        off = (off + COL_ALIGN - 1) & ~(uint64_t)(COL_ALIGN - 1);
+        memset(&desc[i], 0, sizeof(desc[i]));
+        strncpy(desc[i].name, cols[i].name, sizeof(desc[i].name) - 1);
+        desc[i].dtype = (uint8_t)cols[i].dt;
+        desc[i].count = cols[i].count;
+        desc[i].offset = off;
+        off += cols[i].count * dtype_size(cols[i].dt);
+    }
+
+    static const uint8_t zeros[COL_ALIGN] = {0};
+    bool ok = fwrite(magic, sizeof(magic), 1, f) == 1 &&
+              fwrite(hdr, sizeof(hdr), 1, f) == 1 &&
+              (p0_bytes == 0 || fwrite(r->boot_p0, 1, p0_bytes, f) == p0_bytes) &&
+              (p0_pad == 0 || fwrite(zeros, 1, p0_pad, f) == p0_pad) &&
+              fwrite(desc, sizeof(col_desc_t), (size_t)n, f) == (size_t)n;
+
+    for (int i = 0; ok && i < n; i++) {
+        long pos = ftell(f);
+        if (pos < 0 || (uint64_t)pos > desc[i].offset) {
+            ok = false;
+            break;
+        }
+        size_t pad = (size_t)(desc[i].offset - (uint64_t)pos);
+        size_t bytes = (size_t)(cols[i].count * dtype_size(cols[i].dt));
+        ok = (pad == 0 || fwrite(zeros, 1, pad, f) == pad) &&
+             (bytes == 0 || fwrite(cols[i].data, 1, bytes, f) == bytes);
+    }
+
+    return fclose(f) == 0 && ok;
+}
+
+static bool write_npy(const char *dir, const column_t *cols, int n)
+{
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return false;
+
+    for (int i = 0; i < n; i++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s.npy", dir, cols[i].name);
+
+        FILE *f = fopen(path, "wb");
+        if (!f) return false;
+
+        /* NPY v1.0: magic, version, u16 header length, dict padded so data is 64-byte aligned. */
+        char dict[128];
+        int dlen = snprintf(dict, sizeof(dict),
+                            "{'descr': '%s', 'fortran_order': False, 'shape': (%llu,), }",
+                            dtype_npy(cols[i].dt), (unsigned long long)cols[i].count);
+        size_t total = 10 + (size_t)dlen + 1;
+        size_t padded = (total + 63) & ~(size_t)63;
+        uint16_t hlen = (uint16_t)(padded - 10);
+
+        static const char npy_magic[8] = { '\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0 };
+        bool ok = fwrite(npy_magic, 1, 8, f) == 8 && fwrite(&hlen, 2, 1, f) == 1 &&
+                  fwrite(dict, 1, (size_t)dlen, f) == (size_t)dlen;
+        for (size_t k = total - 1; ok && k < padded - 1; k++) ok = fputc(' ', f) != EOF;
+        ok = ok && fputc('\n', f) != EOF;
+
+        size_t bytes = (size_t)(cols[i].count * dtype_size(cols[i].dt));
+        ok = ok && (bytes == 0 || fwrite(cols[i].data, 1, bytes, f) == bytes);
+
+        if (fclose(f) != 0 || !ok) return false;
+    }
+    return true;
+}
+
+static bool write_csv(const char *path, const parsed_t *r)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+
+    static char buf[1 << 20];
+    setvbuf(f, buf, _IOFBF, sizeof(buf));
+
+    const table_t *t = &r->table;
+    fprintf(f, "boot,t_s,ax_g,ay_g,az_g,gx_dps,gy_dps,gz_dps,pressure_pa,alt_m,imu_ok,baro_ok\n");
+    for (uint64_t i = 0; i < r->rows; i++) {
+        fprintf(f, "%u,%.3f,%.5f,%.5f,%.5f,%.3f,%.3f,%.3f,%d,%.2f,%u,%u\n",
+                (unsigned)t->boot[i], t->t_ms[i] / 1000.0,
+                t->ax[i], t->ay[i], t->az[i],
+                t->gx[i], t->gy[i], t->gz[i],
+                (int)t->pressure_pa[i], t->alt_m[i],
+                (unsigned)t->imu_ok[i], (unsigned)t->baro_ok[i]);
+    }
+
+    return fclose(f) == 0;
+}
+
+/* ---- input ------------------------------------------------------------ */
+
+static const char *map_file(const char *path, size_t *size)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *p = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+
+    /* No MAP_POPULATE: on a cold cache the threads parse while readahead fills pages. */
+    (void)madvise(p, (size_t)sb.st_size, MADV_SEQUENTIAL);
+    (void)madvise(p, (size_t)sb.st_size, MADV_WILLNEED);
+    *size = (size_t)sb.st_size;
+    return p;
+}
+
+/* ---- benchmark -------------------------------------------------------- */
+
+static char *put_int(char *p, int64_t v)
+{
+    char tmp[24];
+    int n = 0;
+    bool neg = v < 0;
+    uint64_t u = neg ? (uint64_t)(-v) : (uint64_t)v;
+
+    do {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+
+    if (neg) *p++ = '-';
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+static bool generate(const char *path, uint64_t size_bytes)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+
+    static char buf[1 << 20];
+    size_t len = 0;
+    uint64_t written = 0;
+    uint32_t rng = 0x12345678u;
+
+    len += (size_t)sprintf(buf, "t_ms,ax,ay,az,gx,gy,gz,pressure_pa,imu_ok,baro_ok\n"
+                                "# boot first_sample_ms=12 first_sample_budget_ms=50 "
+                                "first_sd_write_ms=240 first_sd_write_budget_ms=500\n");
+
+    for (uint64_t i = 0; written + len < size_bytes; i++) {
+        if (len > sizeof(buf) - 256) {
+            if (fwrite(buf, 1, len, f) != len) break;
+            written += len;
+            len = 0;
+        }
+
+        char *p = buf + len;
+        uint32_t t = (uint32_t)(i * 10);
+
+        if (i % 10000 == 9999) {
+            p += sprintf(p, "# overwrites=%lu last_overwrite_ms=%lu\n", (unsigned long)(i / 10000), (unsigned long)t);
+        }
+
+        p = put_int(p, t);
+        for (int k = 0; k < 6; k++) {
+            rng = rng * 1664525u + 1013904223u;
+            *p++ = ',';
+            p = put_int(p, (int16_t)(rng >> 16));
+        }
+        *p++ = ',';
+        p = put_int(p, 101325 - (int64_t)(i % 20000));
+        memcpy(p, ",1,1\n", 5);
+        p += 5;
+
+        len = (size_t)(p - buf);
+    }
+
+    bool ok = fwrite(buf, 1, len, f) == len;
+    return fclose(f) == 0 && ok;
+}
+
+static int bench(const char *path, uint64_t size_mb, int threads)
+{
+    double t0 = now_s();
+    if (!generate(path, size_mb << 20)) {
+        perror(path);
+        return 1;
+    }
+    fprintf(stderr, "generated %llu MiB in %.2f s\n", (unsigned long long)size_mb, now_s() - t0);
+
+    /* Baseline: plain sequential read of the same file (page cache warm after generate). */
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return 1;
+    }
+    char *rbuf = xmalloc(1 << 22);
+    uint64_t total = 0;
+    ssize_t r;
+    t0 = now_s();
+    while ((r = read(fd, rbuf, 1 << 22)) > 0) total += (uint64_t)r;
+    double t_read = now_s() - t0;
+    close(fd);
+    free(rbuf);
+
+    t0 = now_s();
+    size_t size = 0;
+    const char *data = map_file(path, &size);
+    if (!data) {
+        perror(path);
+        return 1;
+    }
+    double t_map = now_s() - t0;
+
+    parsed_t res;
+    t0 = now_s();
+    (void)parse_log(data, size, threads, 0.0f, &res);
+    double t_parse = now_s() - t0;
+
+    double gib = (double)total / (1 << 30);
+    printf("sequential read : %.3f s  %.2f GiB/s\n", t_read, gib / t_read);
+    printf("mmap            : %.3f s\n", t_map);
+    printf("parse (%3d thr) : %.3f s  %.2f GiB/s  %.1f Mrows/s  rows=%llu events=%llu bad=%llu\n",
+           threads, t_parse, gib / t_parse, (double)res.rows / t_parse / 1e6,
+           (unsigned long long)res.rows, (unsigned long long)res.overwrites.n,
+           (unsigned long long)res.bad_lines);
+
+    munmap((void *)data, size);
+    table_free(&res.table);
+    events_free(&res.overwrites);
+    free(res.boot_p0);
+    return 0;
+}
+
+/* ---- main ------------------------------------------------------------- */
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [-j THREADS] [-p P0_PA] [-f col|npy|csv] -o OUT flight.csv\n"
+            "       %s -B SIZE_MB [-j THREADS] SCRATCH_FILE\n",
+            argv0, argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    float p0 = 0.0f;
+    const char *fmt = "col";
+    const char *out = NULL;
+    uint64_t bench_mb = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:p:f:o:B:h")) != -1) {
+        switch (opt) {
+        case 'j': threads = atoi(optarg); break;
+        case 'p': p0 = strtof(optarg, NULL); break;
+        case 'f': fmt = optarg; break;
+        case 'o': out = optarg; break;
+        case 'B': bench_mb = strtoull(optarg, NULL, 10); break;
+        default:  usage(argv[0]); return 2;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (bench_mb) return bench(argv[optind], bench_mb, threads);
+
+    if (!out) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    double t0 = now_s();
+
+    size_t size = 0;
+    const char *data = map_file(argv[optind], &size);
+    if (!data) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    parsed_t res;
+    if (!parse_log(data, size, threads, p0, &res)) {
+        fprintf(stderr, "parse failed\n");
+        return 1;
+    }
+    double t_parse = now_s() - t0;
+
+    column_t cols[24];
+    int ncols = build_columns(&res, cols);
+
+    bool ok;
+    if (strcmp(fmt, "col") == 0)      ok = write_col(out, cols, ncols, &res);
+    else if (strcmp(fmt, "npy") == 0) ok = write_npy(out, cols, ncols);
+    else if (strcmp(fmt, "csv") == 0) ok = write_csv(out, &res);
+    else {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!ok) {
+        perror(out);
+        return 1;
+    }
+
+    fprintf(stderr,
+            "%llu rows, %llu overwrite events, %u boots (%llu boot records), %llu bad lines; "
+            "parsed %.1f MiB in %.3f s (%.2f GiB/s), total %.3f s\n",
+            (unsigned long long)res.rows, (unsigned long long)res.overwrites.n,
+            (unsigned)res.n_boots, (unsigned long long)res.boot_records, (unsigned long long)res.bad_lines,
+            size / 1048576.0, t_parse, size / t_parse / (1 << 30), now_s() - t0);
+    for (uint32_t b = 0; b < res.n_boots; b++) {
+        fprintf(stderr, "  boot %u: p0=%.0f Pa\n", (unsigned)b, res.boot_p0[b]);
+    }
+
+    munmap((void *)data, size);
+    table_free(&res.table);
+    events_free(&res.overwrites);
+    free(res.boot_p0);
+    return 0;
+}
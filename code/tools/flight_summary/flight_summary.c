@@ -0,0 +1,289 @@
+/*
+ * Flight overview from the per-window summary file (summary.bin) alone.
+ *
+ *   flight_summary [-p P0_PA] [-w] summary.bin
+ *
+ * -p  reference pressure for altitude (default: mean of the first window)
+ * -w  also print one line per window
+ *
+ * The firmware appends to summary.bin, so one file can hold several boots.
+ * Each restarts its clock, which is how they are told apart; every boot is
+ * reported on its own.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sensor_units.h"
+#include "summary_record.h"
+
+#define PROFILE_COLS    64
+#define PROFILE_ROWS    12
+
+static const char *const k_axis[SUMMARY_IMU_AXES] = { "ax", "ay", "az", "gx", "gy", "gz" };
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float axis_scale(int axis)
+{
+    return axis < 3 ? IMU_ACCEL_LSB_PER_G : IMU_GYRO_LSB_PER_DPS;
+}
+
+static summary_record_t *load(const char *path, size_t *count, size_t *skipped)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *raw = malloc(size > 0 ? (size_t)size : 1);
+    summary_record_t *recs = malloc(size > 0 ? (size_t)size : 1);
+    if (!raw || !recs || fread(raw, 1, (size_t)size, f) != (size_t)size) {
+        fclose(f);
+        free(raw);
+        free(recs);
+        return NULL;
+    }
+    fclose(f);
+
+    /*
+     * Records are fixed size, but a torn write at power loss can leave a
+     * partial one; resync on the magic rather than trusting the stride.
+     */
+    size_t n = 0;
+    *skipped = 0;
+    for (size_t off = 0; off + sizeof(summary_record_t) <= (size_t)size; ) {
+        uint32_t magic;
+        memcpy(&magic, raw + off, sizeof(magic));
+        if (magic != SUMMARY_MAGIC) {
+            off++;
+            (*skipped)++;
+            continue;
+        }
+        memcpy(&recs[n++], raw + off, sizeof(summary_record_t));
+        off += sizeof(summary_record_t);
+    }
+
+    free(raw);
+    *count = n;
+    return recs;
+}
+
+static void print_profile(const summary_record_t *r, size_t n, float p0)
+{
+    float alt[PROFILE_COLS];
+    bool have[PROFILE_COLS] = { false };
+    float lo = INFINITY, hi = -INFINITY;
+
+    uint32_t t0 = r[0].t_start_ms;
+    uint32_t span = r[n - 1].t_end_ms - t0 + 1;
+
+    /* Bin windows into columns, keeping the highest altitude per column. */
+    for (size_t i = 0; i < n; i++) {
+        if (!r[i].n_baro) continue;
+        size_t col = (size_t)((uint64_t)(r[i].t_start_ms - t0) * PROFILE_COLS / span);
+        if (col >= PROFILE_COLS) col = PROFILE_COLS - 1;
+        float a = baro_altitude_m((float)r[i].ch[SUM_PRESSURE].min, p0);
+        if (!have[col] || a > alt[col]) alt[col] = a;
+        have[col] = true;
+        if (a < lo) lo = a;
+        if (a > hi) hi = a;
+    }
+
+    if (lo > hi) return;
+    if (hi - lo < 1.0f) hi = lo + 1.0f;
+
+    printf("\naltitude profile (%.0f .. %.0f m, %.1f s/col)\n", lo, hi, span / 1000.0 / PROFILE_COLS);
+    for (int row = PROFILE_ROWS - 1; row >= 0; row--) {
+        float level = lo + (hi - lo) * (float)row / (PROFILE_ROWS - 1);
+        printf("%7.0f |", level);
+        for (int c = 0; c < PROFILE_COLS; c++) {
+            putchar(have[c] && alt[c] >= level ? '#' : ' ');
+        }
+        putchar('\n');
+    }
+}
+
+/*
+ * End of the boot starting at r[0]: the first window whose start is behind
+ * the previous one's end belongs to the next boot.
+ */
+static size_t segment_len(const summary_record_t *r, size_t n)
+{
+    size_t i = 1;
+    while (i < n && r[i].t_start_ms >= r[i - 1].t_end_ms) i++;
+    return i;
+}
+
+/* r[0..n) is one boot; p0 <= 0 picks that boot's own ground reference. */
+static void report(const summary_record_t *r, size_t n, float p0, bool per_window)
+{
+    if (p0 <= 0.0f) {
+        for (size_t i = 0; i < n && p0 <= 0.0f; i++) {
+            if (r[i].n_baro) p0 = r[i].ch[SUM_PRESSURE].mean;
+        }
+        if (p0 <= 0.0f) p0 = BARO_SEA_LEVEL_PA;
+    }
+
+    /* Peaks across the boot's windows. */
+    int32_t peak_raw[SUMMARY_IMU_AXES] = {0};
+    uint32_t peak_t[SUMMARY_IMU_AXES] = {0};
+    uint32_t sat_total[SUMMARY_IMU_AXES] = {0};
+    size_t sat_windows = 0;
+    int32_t p_min = INT32_MAX;
+    uint32_t p_min_t = 0;
+    uint64_t imu_samples = 0, baro_samples = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const summary_record_t *w = &r[i];
+        bool sat = false;
+
+        imu_samples += w->n_imu;
+        baro_samples += w->n_baro;
+
+        if (w->n_imu) {
+            for (int a = 0; a < SUMMARY_IMU_AXES; a++) {
+                int32_t m = abs(w->ch[a].min) > abs(w->ch[a].max) ? w->ch[a].min : w->ch[a].max;
+                if (abs(m) > abs(peak_raw[a])) {
+                    peak_raw[a] = m;
+                    peak_t[a] = w->t_start_ms;
+                }
+                sat_total[a] += w->saturated[a];
+                if (w->saturated[a]) sat = true;
+            }
+        }
+        if (sat) sat_windows++;
+
+        if (w->n_baro && w->ch[SUM_PRESSURE].min < p_min) {
+            p_min = w->ch[SUM_PRESSURE].min;
+            p_min_t = w->t_start_ms;
+        }
+    }
+
+    double dur = (r[n - 1].t_end_ms - r[0].t_start_ms) / 1000.0;
+    printf("%zu windows over %.1f s (t=%.1f..%.1f s), %llu imu / %llu baro samples\n",
+           n, dur, r[0].t_start_ms / 1000.0, r[n - 1].t_end_ms / 1000.0,
+           (unsigned long long)imu_samples, (unsigned long long)baro_samples);
+
+    printf("reference pressure %.0f Pa\n", p0);
+    if (p_min != INT32_MAX) {
+        printf("apogee: %d Pa -> %.1f m at t=%.1f s\n",
+               (int)p_min, baro_altitude_m((float)p_min, p0), p_min_t / 1000.0);
+    }
+
+    printf("peaks:");
+    for (int a = 0; a < SUMMARY_IMU_AXES; a++) {
+        printf(" %s=%+.2f%s@%.1fs", k_axis[a], peak_raw[a] / axis_scale(a), a < 3 ? "g" : "dps", peak_t[a] / 1000.0);
+    }
+    printf("\n");
+
+    printf("saturation: %zu windows;", sat_windows);
+    for (int a = 0; a < SUMMARY_IMU_AXES; a++) {
+        if (sat_total[a]) printf(" %s=%u", k_axis[a], (unsigned)sat_total[a]);
+    }
+    printf("\n");
+
+    if (sat_windows) {
+        printf("clipped windows:");
+        for (size_t i = 0, shown = 0; i < n && shown < 16; i++) {
+            uint32_t s = 0;
+            for (int a = 0; a < SUMMARY_IMU_AXES; a++) s += r[i].saturated[a];
+            if (s) {
+                printf(" %.1fs(%u)", r[i].t_start_ms / 1000.0, (unsigned)s);
+                shown++;
+            }
+        }
+        printf("\n");
+    }
+
+    if (per_window) {
+        printf("\n   t_s  n_imu n_baro  az_mean_g  az_sd_g  gmax_dps  p_min_pa   alt_m  sat\n");
+        for (size_t i = 0; i < n; i++) {
+            const summary_record_t *w = &r[i];
+            int32_t gmax = 0;
+            uint32_t sat = 0;
+            for (int a = 3; a < SUMMARY_IMU_AXES; a++) {
+                if (abs(w->ch[a].min) > gmax) gmax = abs(w->ch[a].min);
+                if (abs(w->ch[a].max) > gmax) gmax = abs(w->ch[a].max);
+            }
+            for (int a = 0; a < SUMMARY_IMU_AXES; a++) sat += w->saturated[a];
+
+            printf("%6.1f %6u %6u %10.3f %8.3f %9.1f %9d %7.1f %4u\n",
+                   w->t_start_ms / 1000.0, w->n_imu, w->n_baro,
+                   w->ch[SUM_AZ].mean / IMU_ACCEL_LSB_PER_G,
+                   sqrtf(w->ch[SUM_AZ].var) / IMU_ACCEL_LSB_PER_G,
+                   gmax / IMU_GYRO_LSB_PER_DPS,
+                   (int)w->ch[SUM_PRESSURE].min,
+                   w->n_baro ? baro_altitude_m((float)w->ch[SUM_PRESSURE].min, p0) : 0.0f,
+                   (unsigned)sat);
+        }
+    }
+
+    print_profile(r, n, p0);
+}
+
+int main(int argc, char **argv)
+{
+    float p0 = 0.0f;
+    bool per_window = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:wh")) != -1) {
+        switch (opt) {
+        case 'p': p0 = strtof(optarg, NULL); break;
+        case 'w': per_window = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-p P0_PA] [-w] summary.bin\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-p P0_PA] [-w] summary.bin\n", argv[0]);
+        return 2;
+    }
+
+    double t_begin = now_s();
+
+    size_t n = 0, skipped = 0;
+    summary_record_t *r = load(argv[optind], &n, &skipped);
+    if (!r) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (n == 0) {
+        fprintf(stderr, "%s: no summary records\n", argv[optind]);
+        free(r);
+        return 1;
+    }
+
+    size_t boots = 0;
+    for (size_t i = 0; i < n; i += segment_len(r + i, n - i)) boots++;
+
+    printf("%s: %zu windows, %zu boot%s", argv[optind], n, boots, boots == 1 ? "" : "s");
+    if (skipped) printf(", %zu bytes skipped", skipped);
+    printf("\n");
+
+    for (size_t i = 0, b = 1; i < n; b++) {
+        size_t len = segment_len(r + i, n - i);
+        printf("\n== boot %zu/%zu: ", b, boots);
+        report(r + i, len, p0, per_window);
+        i += len;
+    }
+
+    fprintf(stderr, "\n(%.2f ms)\n", (now_s() - t_begin) * 1000.0);
+
+    free(r);
+    return 0;
+}
@@ -0,0 +1,391 @@
+/*
+ * Host side of the serial log download (see main/inc/log_download_proto.h).
+ *
+ *   logdl_client -d /dev/ttyUSB0 [-b 921600] [-c 115200] [-f flight.csv] [-o out.csv] [-n]
+ *
+ * If the output file already exists the transfer resumes from its size. A
+ * dropped link (timeouts or the tty disappearing) is retried by reopening the
+ * port and sending a fresh OPEN at the bytes already saved.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log_download_proto.h"
+
+#define RX_TIMEOUT_MS       1000
+#define MAX_SILENT_RETRIES  5
+#define MAX_REOPENS         20
+
+typedef struct
+{
+    const char *dev;
+    const char *remote;
+    const char *out;
+    unsigned baud;
+    unsigned console_baud;
+    bool enter;
+} opts_t;
+
+typedef struct
+{
+    uint64_t bytes;
+    uint32_t chunks;
+    uint32_t crc_errors;
+    uint32_t naks;
+    uint32_t reopens;
+} stats_t;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static speed_t baud_const(unsigned baud)
+{
+    switch (baud) {
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    default:      return 0;
+    }
+}
+
+static bool set_baud(int fd, unsigned baud)
+{
+    struct termios tio;
+    speed_t sp = baud_const(baud);
+
+    if (!sp || tcgetattr(fd, &tio) != 0) return false;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, sp);
+    cfsetospeed(&tio, sp);
+
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+static int open_port(const opts_t *o)
+{
+    int fd = open(o->dev, O_RDWR | O_NOCTTY);
+    if (fd < 0) return -1;
+
+    if (o->enter) {
+        /* Ask the console to switch into download mode, then follow its baud change. */
+        static const char cmd[] = "\ndownload\n";
+        if (!set_baud(fd, o->console_baud) || write(fd, cmd, sizeof(cmd) - 1) < 0) {
+            close(fd);
+            return -1;
+        }
+        tcdrain(fd);
+        usleep(200 * 1000);
+    }
+
+    if (!set_baud(fd, o->baud)) {
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+    return fd;
+}
+
+static bool write_all(int fd, const void *p, size_t n)
+{
+    const uint8_t *b = p;
+    while (n) {
+        ssize_t w = write(fd, b, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        b += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+static bool send_frame(int fd, uint8_t type, uint32_t offset, const void *payload, uint16_t len)
+{
+    logdl_hdr_t h = {
+        .sync = { LOGDL_SYNC0, LOGDL_SYNC1 },
+        .type = type,
+        .offset = offset,
+        .len = len,
+    };
+    h.crc = logdl_frame_crc(&h, payload);
+
+    return write_all(fd, &h, sizeof(h)) && (len == 0 || write_all(fd, payload, len));
+}
+
+/* Returns 1 on a byte, 0 on timeout, -1 if the port went away. */
+static int read_byte(int fd, uint8_t *c, int timeout_ms)
+{
+    for (;;) {
+        ssize_t r = read(fd, c, 1);
+        if (r == 1) return 1;
+        if (r < 0 && errno != EAGAIN && errno != EINTR) return -1;
+
+        fd_set rd;
+        FD_ZERO(&rd);
+        FD_SET(fd, &rd);
+        struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+
+        int s = select(fd + 1, &rd, NULL, NULL, &tv);
+        if (s == 0) return 0;
+        if (s < 0 && errno != EINTR) return -1;
+
+        /* Readable but read() returns 0: tty hung up. */
+        r = read(fd, c, 1);
+        if (r == 1) return 1;
+        if (r == 0 || (r < 0 && errno != EAGAIN && errno != EINTR)) return -1;
+    }
+}
+
+static int read_exact(int fd, void *dst, size_t n, int timeout_ms)
+{
+    uint8_t *p = dst;
+    for (size_t i = 0; i < n; i++) {
+        int r = read_byte(fd, &p[i], timeout_ms);
+        if (r <= 0) return r;
+    }
+    return 1;
+}
+
+/* 1 = good frame, 0 = timeout, -1 = port gone, -2 = corrupt frame */
+static int recv_frame(int fd, logdl_hdr_t *h, uint8_t *payload, int timeout_ms)
+{
+    uint8_t c = 0;
+    int r;
+
+    do {
+        if ((r = read_byte(fd, &c, timeout_ms)) <= 0) return r;
+    } while (c != LOGDL_SYNC0);
+
+    if ((r = read_byte(fd, &c, timeout_ms)) <= 0) return r;
+    if (c != LOGDL_SYNC1) return -2;
+
+    h->sync[0] = LOGDL_SYNC0;
+    h->sync[1] = LOGDL_SYNC1;
+    if ((r = read_exact(fd, &h->type, sizeof(*h) - 2, timeout_ms)) <= 0) return r;
+    if (h->len > LOGDL_MAX_PAYLOAD) return -2;
+    if (h->len && (r = read_exact(fd, payload, h->len, timeout_ms)) <= 0) return r;
+
+    return logdl_frame_crc(h, payload) == h->crc ? 1 : -2;
+}
+
+static const char *err_name(uint8_t e)
+{
+    switch (e) {
+    case LOGDL_ERR_NO_CARD:   return "no SD card";
+    case LOGDL_ERR_NOT_FOUND: return "file not found";
+    case LOGDL_ERR_IO:        return "read error on device";
+    case LOGDL_ERR_BAD_NAME:  return "bad file name";
+    default:                  return "unknown error";
+    }
+}
+
+/*
+ * One connection's worth of transfer. Returns 1 when the file is complete,
+ * 0 if the link dropped and a resume should be attempted, -1 on a hard error.
+ */
+static int session(int fd, const opts_t *o, FILE *out, uint64_t *have, stats_t *st, bool *got_info)
+{
+    static uint8_t payload[LOGDL_MAX_PAYLOAD];
+    logdl_hdr_t h;
+
+    if (!send_frame(fd, LOGDL_OPEN, (uint32_t)*have, o->remote, (uint16_t)strlen(o->remote))) return 0;
+
+    uint32_t size = 0;
+    bool have_info = false;
+    bool nak_pending = false;
+    int silent = 0;
+
+    for (;;) {
+        int r = recv_frame(fd, &h, payload, RX_TIMEOUT_MS);
+
+        if (r == -1) return 0;
+        if (r == -2) {
+            st->crc_errors++;
+            continue;
+        }
+        if (r == 0) {
+            /* Re-ACK (or re-OPEN) so a lost control frame cannot stall us. */
+            if (++silent > MAX_SILENT_RETRIES) return 0;
+            if (!have_info) {
+                if (!send_frame(fd, LOGDL_OPEN, (uint32_t)*have, o->remote, (uint16_t)strlen(o->remote))) return 0;
+            } else if (!send_frame(fd, LOGDL_ACK, (uint32_t)*have, NULL, 0)) {
+                return 0;
+            }
+            continue;
+        }
+        silent = 0;
+
+        switch (h.type) {
+        case LOGDL_INFO:
+            size = h.offset;
+            have_info = true;
+            *got_info = true;
+            if (*have > size) {
+                fprintf(stderr, "local file is larger than remote (%llu > %u)\n",
+                        (unsigned long long)*have, (unsigned)size);
+                return -1;
+            }
+            fprintf(stderr, "remote size %u bytes, starting at %llu\n", (unsigned)size, (unsigned long long)*have);
+            break;
+
+        case LOGDL_ERROR:
+            fprintf(stderr, "device: %s\n", err_name(h.flags));
+            return -1;
+
+        case LOGDL_DATA:
+            if (!have_info) break;
+
+            if (h.offset == *have) {
+                if (fwrite(payload, 1, h.len, out) != h.len) {
+                    perror("write");
+                    return -1;
+                }
+                *have += h.len;
+                st->bytes += h.len;
+                st->chunks++;
+                nak_pending = false;
+                if (!send_frame(fd, LOGDL_ACK, (uint32_t)*have, NULL, 0)) return 0;
+            } else if (h.offset > *have && !nak_pending) {
+                /* Gap: one NAK per gap, the rest of the window is discarded. */
+                nak_pending = true;
+                st->naks++;
+                if (!send_frame(fd, LOGDL_NAK, (uint32_t)*have, NULL, 0)) return 0;
+            } else if (h.offset < *have) {
+                /*
+                 * Already have it: our ACK was lost and the device rewound.
+                 * Re-ACK, or it resends the same chunk until its idle timeout.
+                 */
+                if (!send_frame(fd, LOGDL_ACK, (uint32_t)*have, NULL, 0)) return 0;
+            }
+            break;
+
+        case LOGDL_DONE:
+            if (*have == h.offset) {
+                (void)send_frame(fd, LOGDL_QUIT, 0, NULL, 0);
+                return 1;
+            }
+            if (!send_frame(fd, LOGDL_ACK, (uint32_t)*have, NULL, 0)) return 0;
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s -d DEVICE [-b BAUD] [-c CONSOLE_BAUD] [-f REMOTE_NAME] [-o OUTPUT] [-n]\n"
+            "  -n  device is already in download mode (do not send the console command)\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    opts_t o = {
+        .dev = NULL,
+        .remote = "flight.csv",
+        .out = NULL,
+        .baud = 921600,
+        .console_baud = 115200,
+        .enter = true,
+    };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:b:c:f:o:nh")) != -1) {
+        switch (opt) {
+        case 'd': o.dev = optarg; break;
+        case 'b': o.baud = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'c': o.console_baud = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'f': o.remote = optarg; break;
+        case 'o': o.out = optarg; break;
+        case 'n': o.enter = false; break;
+        default:  usage(argv[0]); return 2;
+        }
+    }
+
+    if (!o.dev || strlen(o.remote) == 0 || strlen(o.remote) > LOGDL_MAX_NAME) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!baud_const(o.baud) || !baud_const(o.console_baud)) {
+        fprintf(stderr, "unsupported baud rate\n");
+        return 2;
+    }
+    if (!o.out) o.out = o.remote;
+
+    FILE *out = fopen(o.out, "ab");
+    if (!out) {
+        perror(o.out);
+        return 1;
+    }
+    struct stat sb;
+    uint64_t have = (fstat(fileno(out), &sb) == 0) ? (uint64_t)sb.st_size : 0;
+
+    stats_t st = {0};
+    double t0 = now_s();
+    int result = 0;
+
+    for (uint32_t attempt = 0; attempt <= MAX_REOPENS; attempt++) {
+        int fd = open_port(&o);
+        if (fd < 0) {
+            sleep(1);
+            continue;
+        }
+
+        bool got_info = false;
+        result = session(fd, &o, out, &have, &st, &got_info);
+        fflush(out);
+        close(fd);
+
+        if (result != 0) break;
+
+        st.reopens++;
+        fprintf(stderr, "link lost at %llu bytes, resuming\n", (unsigned long long)have);
+
+        /*
+         * A re-plug usually resets the board, and the device's idle timeout
+         * also drops it back to the console. The command is harmless if it is
+         * still in download mode (it is not a valid frame), so it is sent on
+         * every reconnect; with -n only once OPEN has gone unanswered.
+         */
+        if (!got_info) o.enter = true;
+        sleep(1);
+    }
+
+    fclose(out);
+
+    double dt = now_s() - t0;
+    fprintf(stderr,
+            "%s: %llu bytes in %.2f s = %.1f KiB/s (chunks=%u naks=%u crc_errors=%u resumes=%u)\n",
+            result == 1 ? "complete" : "incomplete",
+            (unsigned long long)st.bytes, dt,
+            dt > 0 ? (double)st.bytes / 1024.0 / dt : 0.0,
+            st.chunks, st.naks, st.crc_errors, st.reopens);
+
+    return result == 1 ? 0 : 1;
+}
@@ -0,0 +1,388 @@
+/*
+ * Loopback test for the serial log download, over a Linux pty.
+ *
+ *   logdl_loopback_test PATH_TO_LOGDL_CLIENT
+ *
+ * The parent process plays the board on the pty master: a console that
+ * takes "download", then the firmware's own session code from
+ * log_download_core.c, and runs the real logdl_client against the slave.
+ * The I/O glue injects the faults a real link sees:
+ *
+ *   - corrupted DATA payloads (CRC failure on the host -> NAK)
+ *   - dropped DATA frames (gap -> NAK, go-back-N)
+ *   - the ACK for the final chunk lost once (device rewinds, host must re-ACK)
+ *   - a board reset part-way through: silence, then back on the console
+ *
+ * The client starts with part of the file already saved, so the resume path
+ * is covered too. Passes if the output matches byte for byte in bounded time.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "log_download_core.h"
+
+/* Device timing, as in app_conifg.h. */
+#define WINDOW_CHUNKS       8
+#define POLL_MS             10
+#define ACK_TIMEOUT_MS      250
+#define IDLE_TIMEOUT_MS     30000
+
+#define FILE_BYTES          (300 * 1024 + 123)
+#define PRESAVED_BYTES      10000
+#define CORRUPT_EVERY       7
+#define DROP_EVERY          11
+#define RESET_AT_PERCENT    40
+#define RESET_SILENCE_MS    3000
+#define TIME_LIMIT_S        25.0
+
+static const char k_remote[] = "flight.csv";
+
+static int s_master = -1;
+static pid_t s_child = -1;
+static int s_child_status = 0;
+static bool s_child_exited = false;
+
+static uint8_t *s_file;
+static uint32_t s_size;
+
+static uint8_t s_rx_payload[LOGDL_MAX_PAYLOAD];
+
+/* Injected faults and what they provoked. */
+static uint32_t s_data_frames;
+static uint32_t s_corrupted, s_dropped, s_rewinds;
+static bool s_final_ack_dropped;
+static bool s_reset_done;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(now_s() * 1000.0);
+}
+
+static bool child_done(void)
+{
+    if (!s_child_exited && waitpid(s_child, &s_child_status, WNOHANG) == s_child) {
+        s_child_exited = true;
+    }
+    return s_child_exited;
+}
+
+/* ---- emulated UART ------------------------------------------------------ */
+
+static bool uart_read(void *dst, size_t n, int timeout_ms)
+{
+    uint8_t *p = dst;
+    while (n) {
+        struct pollfd pfd = { .fd = s_master, .events = POLLIN };
+        if (poll(&pfd, 1, timeout_ms) <= 0) return false;
+
+        ssize_t r = read(s_master, p, n);
+        if (r <= 0) {
+            /* EIO while no slave is open: the client is between reconnects. */
+            usleep(1000);
+            continue;
+        }
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+static void uart_write(const void *src, size_t n)
+{
+    const uint8_t *p = src;
+    while (n) {
+        ssize_t w = write(s_master, p, n);
+        if (w < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+static void send_frame(uint8_t type, uint8_t flags, uint32_t offset, const void *payload, uint16_t len, bool corrupt)
+{
+    static uint8_t buf[sizeof(logdl_hdr_t) + LOGDL_MAX_PAYLOAD];
+
+    logdl_hdr_t h = {
+        .sync = { LOGDL_SYNC0, LOGDL_SYNC1 },
+        .type = type,
+        .flags = flags,
+        .offset = offset,
+        .len = len,
+    };
+    h.crc = logdl_frame_crc(&h, payload);
+
+    memcpy(buf, &h, sizeof(h));
+    if (len) memcpy(buf + sizeof(h), payload, len);
+    if (corrupt && len) buf[sizeof(h) + len / 2] ^= 0x5A;
+
+    uart_write(buf, sizeof(h) + len);
+}
+
+static bool recv_frame(logdl_hdr_t *h, int timeout_ms)
+{
+    uint8_t c;
+
+    do {
+        if (!uart_read(&c, 1, timeout_ms)) return false;
+    } while (c != LOGDL_SYNC0);
+
+    if (!uart_read(&c, 1, timeout_ms) || c != LOGDL_SYNC1) return false;
+
+    h->sync[0] = LOGDL_SYNC0;
+    h->sync[1] = LOGDL_SYNC1;
+    if (!uart_read(&h->type, sizeof(*h) - 2, timeout_ms)) return false;
+
+    if (h->len > LOGDL_MAX_PAYLOAD) return false;
+    if (h->len && !uart_read(s_rx_payload, h->len, timeout_ms)) return false;
+
+    return logdl_frame_crc(h, s_rx_payload) == h->crc;
+}
+
+/* ---- emulated device ---------------------------------------------------- */
+
+static logdl_err_t dev_open(void *ctx, const uint8_t *name, uint16_t len, uint32_t *size)
+{
+    (void)ctx;
+    if (len != sizeof(k_remote) - 1 || memcmp(name, k_remote, len) != 0) return LOGDL_ERR_NOT_FOUND;
+    *size = s_size;
+    return 0;
+}
+
+static void dev_close(void *ctx)
+{
+    (void)ctx;
+}
+
+static const uint8_t *dev_read(void *ctx, uint32_t offset, uint16_t len)
+{
+    (void)ctx;
+    return offset + len <= s_size ? &s_file[offset] : NULL;
+}
+
+static void dev_send(void *ctx, uint8_t type, uint8_t flags, uint32_t offset, const void *payload, uint16_t len)
+{
+    (void)ctx;
+    bool corrupt = false;
+
+    if (type == LOGDL_DATA) {
+        s_data_frames++;
+        if (s_data_frames % DROP_EVERY == 0) {
+            s_dropped++;
+            return;
+        }
+        corrupt = s_data_frames % CORRUPT_EVERY == 0;
+        if (corrupt) s_corrupted++;
+    }
+    send_frame(type, flags, offset, payload, len, corrupt);
+}
+
+static const logdl_io_t k_io = {
+    .open = dev_open,
+    .close = dev_close,
+    .read = dev_read,
+    .send = dev_send,
+};
+
+/* The loop in log_download.c's serve(). Returns false if the "board" reset. */
+static bool serve(void)
+{
+    logdl_session_t s;
+    logdl_session_init(&s, &k_io, WINDOW_CHUNKS * LOGDL_MAX_PAYLOAD, ACK_TIMEOUT_MS, IDLE_TIMEOUT_MS, now_ms());
+
+    bool alive = true;
+    while (alive && !child_done())
+    {
+        logdl_session_pump(&s, now_ms());
+
+        if (s.active && !s_reset_done && s.base >= (uint64_t)s_size * RESET_AT_PERCENT / 100) {
+            s_reset_done = true;
+            s_rewinds += s.rewinds;
+            return false;
+        }
+
+        logdl_hdr_t h;
+        if (recv_frame(&h, POLL_MS)) {
+            bool drop = h.type == LOGDL_ACK && h.offset == s_size && !s_final_ack_dropped;
+            if (drop) s_final_ack_dropped = true;
+            else      alive = logdl_session_handle(&s, &h, s_rx_payload, now_ms());
+        }
+
+        if (alive) alive = logdl_session_tick(&s, now_ms());
+    }
+
+    s_rewinds += s.rewinds;
+    return true;
+}
+
+/* Line console: only "download" matters, everything else is ignored. */
+static void run_device(void)
+{
+    char line[64];
+    size_t len = 0;
+
+    while (!child_done()) {
+        uint8_t c;
+        if (!uart_read(&c, 1, 100)) continue;
+
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (len < sizeof(line) - 1) line[len++] = (char)c;
+            continue;
+        }
+
+        line[len] = '\0';
+        len = 0;
+        if (strcmp(line, "download") != 0) continue;
+
+        if (!serve()) {
+            /* Reset: the board is gone for a while, then boots to the console. */
+            double until = now_s() + RESET_SILENCE_MS / 1000.0;
+            while (now_s() < until) {
+                uint8_t junk[256];
+                (void)uart_read(junk, 1, 50);
+            }
+        }
+    }
+}
+
+/* ---- harness ------------------------------------------------------------ */
+
+static bool write_file(const char *path, const uint8_t *data, size_t n)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(data, 1, n, f) == n;
+    return fclose(f) == 0 && ok;
+}
+
+static uint8_t *read_file(const char *path, size_t *n)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    struct stat sb;
+    if (fstat(fileno(f), &sb) != 0) {
+        fclose(f);
+        return NULL;
+    }
+
+    uint8_t *p = malloc((size_t)sb.st_size + 1);
+    *n = p ? fread(p, 1, (size_t)sb.st_size, f) : 0;
+    fclose(f);
+    return p;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s PATH_TO_LOGDL_CLIENT\n", argv[0]);
+        return 2;
+    }
+
+    /* A CSV-like payload with a deterministic pattern. */
+    s_size = FILE_BYTES;
+    s_file = malloc(s_size);
+    uint32_t rng = 0x2468ACE1u;
+    for (uint32_t i = 0; i < s_size; i++) {
+        rng = rng * 1103515245u + 12345u;
+        s_file[i] = (i % 64 == 63) ? '\n' : (uint8_t)('0' + (rng >> 16) % 10);
+    }
+
+    char dir[] = "/tmp/logdl_test_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char out[sizeof(dir) + 16];
+    snprintf(out, sizeof(out), "%s/out.csv", dir);
+
+    if (!write_file(out, s_file, PRESAVED_BYTES)) {
+        perror(out);
+        return 1;
+    }
+
+    s_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (s_master < 0 || grantpt(s_master) != 0 || unlockpt(s_master) != 0) {
+        perror("pty");
+        return 1;
+    }
+    const char *slave = ptsname(s_master);
+
+    /*
+     * Keep a raw slave handle open for the whole test: it stops the line
+     * discipline echoing, and the master does not hang up while the client
+     * is between reconnects.
+     */
+    int keep = open(slave, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (keep < 0 || tcgetattr(keep, &tio) != 0) {
+        perror(slave);
+        return 1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(keep, TCSANOW, &tio);
+
+    double t0 = now_s();
+
+    s_child = fork();
+    if (s_child == 0) {
+        close(s_master);
+        close(keep);
+        execl(argv[1], argv[1], "-d", slave, "-f", k_remote, "-o", out, (char *)NULL);
+        perror(argv[1]);
+        _exit(127);
+    }
+    if (s_child < 0) {
+        perror("fork");
+        return 1;
+    }
+
+    run_device();
+    double dt = now_s() - t0;
+
+    size_t got_n = 0;
+    uint8_t *got = read_file(out, &got_n);
+    bool same = got && got_n == s_size && memcmp(got, s_file, s_size) == 0;
+    bool client_ok = WIFEXITED(s_child_status) && WEXITSTATUS(s_child_status) == 0;
+
+    printf("loopback: %.2f s, data_frames=%u corrupted=%u dropped=%u rewinds=%u "
+           "final_ack_dropped=%d reset=%d client_exit=%d match=%d\n",
+           dt, s_data_frames, s_corrupted, s_dropped, s_rewinds,
+           s_final_ack_dropped, s_reset_done,
+           WIFEXITED(s_child_status) ? WEXITSTATUS(s_child_status) : -1, same);
+
+    unlink(out);
+    rmdir(dir);
+    free(got);
+    free(s_file);
+
+    if (!client_ok || !same) return 1;
+    if (!s_final_ack_dropped || !s_reset_done) return 1;
+    if (dt > TIME_LIMIT_S) {
+        printf("loopback: took longer than %.0f s\n", TIME_LIMIT_S);
+        return 1;
+    }
+    return 0;
+}